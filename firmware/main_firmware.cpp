@@ -15,6 +15,7 @@
 
 #include <stdbool.h>
 #include <stdint.h>
+#include <string.h>
 #include <util/delay.h>
 #include <avr/io.h>
 #include <avr/wdt.h>
@@ -37,30 +38,49 @@
 #include "scheduler.h"
 #include "state_reducer.h"
 #include "schedule_apply.h"
+#include "event_log.h"
+#include "ee_async.h"
+#include "energy.h"
+#include "latency.h"
+#include "mem.h"
+#include "metrics.h"
+#include "power.h"
+#include "clock.h"
+#include "warm_state.h"
+#include "actuator_store.h"
+#include "timer.h"
+#include "irq_queue.h"
+#include "task.h"
+#include "input.h"
 
 #include "devices/devices.h"
 #include "devices/led_state_machine.h"
 #include "devices/door_state_machine.h"
+#include "door_lock.h"
 
 #include "platform/gpio_avr.h"
 #include "platform/i2c.h"
 
 
 /* ============================================================================
- * INT0 WAKE (PD2)
+ * INT0 (PD2, RTC alarm) / INT1 (PD3, door button)
+ *
+ * Low-level triggered: each ISR masks itself and queues one event;
+ * the main loop re-arms once the line is released.
  * ========================================================================== */
 
 ISR(INT0_vect)
 {
+    latency_isr_wake(LAT_SRC_RTC);
     EIMSK &= (uint8_t)~(1u << INT0);
+    (void)irq_queue_push(IRQ_EV_RTC_ALARM);
 }
 
-static volatile uint8_t g_door_event = 0;
-
 ISR(INT1_vect)
 {
+    latency_isr_wake(LAT_SRC_BUTTON);
     EIMSK &= (uint8_t)~(1u << INT1);
-    g_door_event = 1u;
+    (void)irq_queue_push(IRQ_EV_BUTTON);
 }
 
 
@@ -87,6 +107,112 @@ static inline uint16_t strictly_future_minute(uint16_t now_min,
 }
 
 
+/* ============================================================================
+ * AUDIT LOG
+ * ========================================================================== */
+
+/* Record the motion a button press actually started (if any) */
+static void log_button_toggle(void)
+{
+    door_motion_t m = door_sm_get_motion();
+
+    if (m == DOOR_MOVING_OPEN || m == DOOR_MOVING_CLOSE)
+        latency_mark_action();
+
+    if (m == DOOR_MOVING_OPEN)
+        event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_ON, EVLOG_SRC_BUTTON);
+    else if (m == DOOR_MOVING_CLOSE)
+        event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_OFF, EVLOG_SRC_BUTTON);
+}
+
+
+/* ============================================================================
+ * DOOR BUTTON
+ *
+ *   press        toggle the door
+ *   double press lock only: re-drive the lock of a closed door
+ *   long press   skip the next scheduled door change (again: undo)
+ *
+ * CONFIG switch changes are read with input_level() in the loop.
+ * ========================================================================== */
+
+static void on_input(input_id_t id, input_gesture_t g, uint32_t now_ms)
+{
+    (void)now_ms;
+
+    if (id != INPUT_DOOR_SW)
+        return;
+
+    switch (g) {
+
+    case INPUT_GESTURE_PRESS:
+        metric_inc(METRIC_DOOR_BUTTON);
+        door_sm_toggle();
+        log_button_toggle();
+        break;
+
+    case INPUT_GESTURE_DOUBLE:
+        if (door_sm_get_motion() == DOOR_IDLE_CLOSED)
+            door_lock_engage_force();
+        break;
+
+    case INPUT_GESTURE_LONG: {
+        bool skip = !schedule_apply_skip_pending(DEVICE_ID_DOOR);
+
+        schedule_apply_skip_next(DEVICE_ID_DOOR, skip);
+        led_state_machine_set(LED_BLINK, skip ? LED_GREEN : LED_RED, 2);
+        break;
+    }
+
+    default:
+        break;
+    }
+}
+
+
+/* ============================================================================
+ * ISR EVENTS
+ * ========================================================================== */
+
+/* Is the oldest pending event (the wake cause after a sleep) of this type? */
+static bool irq_first_is(irq_ev_t type)
+{
+    struct irq_event ev;
+
+    return irq_queue_peek(&ev) && ev.type == type;
+}
+
+/* Handle queued ISR events in arrival order */
+static void irq_drain(bool *force_time_read)
+{
+    struct irq_event ev;
+
+    while (irq_queue_pop(&ev)) {
+        switch (ev.type) {
+
+        case IRQ_EV_BUTTON:
+            /* Sampling starts at the edge, not at the drain */
+            input_edge(INPUT_DOOR_SW, irq_event_ms(&ev));
+            break;
+
+        case IRQ_EV_CONFIG_SW:
+            input_edge(INPUT_CONFIG_SW, irq_event_ms(&ev));
+            break;
+
+        case IRQ_EV_RTC_ALARM:
+            /* Alarm while awake: the minute moved under the cache */
+            *force_time_read = true;
+            rtc_alarm_int_rearm();
+            break;
+
+        default:
+            /* IDLE wake: timer_run() handles the deadline */
+            break;
+        }
+    }
+}
+
+
 /* ============================================================================
  * RESET CAUSE
  * ========================================================================== */
@@ -103,11 +229,139 @@ static void reset_cause_capture_early(void)
     MCUCR |= _BV(JTD);
 }
 
+/* Reset with RAM retained (WDT / brown-out / external), not power-on */
+static bool reset_is_warm(void)
+{
+    return g_reset_flags != 0 && !(g_reset_flags & _BV(PORF));
+}
+
 static void reset_cause_debug_print(void)
 {
-    if (g_reset_flags & _BV(PORF))  mini_printf("RESET: Power On\n");
-    if (g_reset_flags & _BV(BORF))  mini_printf("RESET: Brown-Out\n");
-    if (g_reset_flags & _BV(WDRF))  mini_printf("RESET: Watchdog\n");
+    if (g_reset_flags & _BV(PORF))  mini_printf(FSTR("RESET: Power On\n"));
+    if (g_reset_flags & _BV(BORF))  mini_printf(FSTR("RESET: Brown-Out\n"));
+    if (g_reset_flags & _BV(WDRF))  mini_printf(FSTR("RESET: Watchdog\n"));
+
+    if (mem_last_trip() == MEM_TRIP_STACK_CANARY)
+        mini_printf(FSTR("RESET: Stack overflow (canary)\n"));
+}
+
+
+/* ============================================================================
+ * SLEEP GATING / FAULT MODE
+ * ========================================================================== */
+
+#define FAULT_FLASH_MS  30u
+
+/* Work in flight that must finish awake */
+static bool sleep_blocked(void)
+{
+    return devices_busy() ||
+           ee_async_busy() ||
+           metrics_busy() ||
+           input_active() ||
+           task_busy() ||
+           !irq_queue_empty();
+}
+
+/*
+ * Awake only because of pending deadlines (soft timers, device
+ * ticks): IDLE until the earliest one instead of spinning.
+ * Anything that still needs the loop (EEPROM queue, a fresh
+ * button edge, a device due every pass) keeps it spinning.
+ *
+ * dev_left: ms to the earliest device deadline (device_tick()).
+ */
+static void idle_until_deadline(uint32_t dev_left)
+{
+    uint32_t left;
+
+    /* Queued ISR events: system_sleep_idle_ms() checks with
+       interrupts off, so none can slip in before the sleep */
+    if (ee_async_busy() || metrics_busy())
+        return;
+
+    if (!timer_next_deadline(uptime_millis(), &left) || dev_left < left)
+        left = dev_left;
+
+    if (left == DEVICE_NO_DEADLINE)
+        return;
+
+    system_sleep_idle_ms(left);
+}
+
+/*
+ * Settled device states, per ID. The door reports intent while
+ * moving, so it is taken from its motion state instead.
+ * Returns true if the lock is driven home.
+ */
+static bool settled_states(uint8_t *out)
+{
+    for (uint8_t id = 0; id < DEVICE_ID_TABLE_SIZE; id++) {
+        dev_state_t st = DEV_STATE_UNKNOWN;
+        (void)device_get_state_by_id(id, &st);
+        out[id] = (uint8_t)st;
+    }
+
+    door_motion_t m = door_sm_get_motion();
+
+    out[DEVICE_ID_DOOR] =
+        (m == DOOR_IDLE_OPEN)   ? (uint8_t)DEV_STATE_ON  :
+        (m == DOOR_IDLE_CLOSED) ? (uint8_t)DEV_STATE_OFF :
+                                  (uint8_t)DEV_STATE_UNKNOWN;
+
+    return door_lock_get_state() == LOCK_STATE_LOCKED;
+}
+
+/*
+ * Snapshot for a warm reset. Only called right before sleep,
+ * when every device is settled.
+ */
+static void warm_capture(void)
+{
+    struct warm_state ws;
+
+    ws.sched        = g_scheduler;
+    ws.lock_engaged = settled_states(ws.dev_state);
+
+    warm_state_save(&ws);
+}
+
+/* Fault indication: one short red flash */
+static void fault_flash(void)
+{
+    led_state_machine_set(LED_ON, LED_RED);
+
+    uint32_t t0 = uptime_millis();
+    while ((uint32_t)(uptime_millis() - t0) < FAULT_FLASH_MS)
+        led_state_machine_tick(uptime_millis());
+
+    led_state_machine_set(LED_OFF, LED_RED);
+}
+
+/*
+ * PWR_DOWN until the watchdog (~2 s), the door button or the
+ * CONFIG switch. A full watchdog period is known wall time and
+ * counts toward the RTC oscillator proof.
+ */
+static void sleep_bounded(void)
+{
+    warm_capture();
+    energy_wake_end(uptime_millis());
+
+    if (system_sleep_fault())
+        rtc_osc_credit_ms(SYSTEM_SLEEP_FAULT_S * 1000ul);
+
+    energy_wake_begin(irq_first_is(IRQ_EV_BUTTON) ? ENERGY_WAKE_BUTTON
+                                                   : ENERGY_WAKE_OTHER,
+                      uptime_millis());
+}
+
+static void reboot(void)
+{
+    cli();
+    wdt_enable(WDTO_15MS);
+    for (;;) {
+    }
 }
 
 
@@ -120,20 +374,42 @@ static void reset_cause_debug_print(void)
      bool rtc_valid = false;
 
      reset_cause_capture_early();
+     mem_init();
+     metrics_init();
+
+     /* Single use: a crash before the next sleep boots cold */
+     struct warm_state warm;
+     bool warm_boot = reset_is_warm() && warm_state_load(&warm);
+     warm_state_invalidate();
 
      if (g_reset_flags & _BV(BORF)) {
          _delay_ms(50);
      }
 
+     /* Awake baseline: 1 MHz; drivers below time from clock_hz() */
+     clock_init();
+
      uart_init();
      uptime_init();
      coop_gpio_init();
+     power_init();
 
      if (!i2c_init(100000)) {
+         /* No bus: nothing can run. Indicate from PWR_DOWN and
+            retry the boot when someone touches the box. */
          led_state_machine_init();
-         led_state_machine_set(LED_BLINK, LED_RED);
+         system_sleep_init();
+         sei();
+
+         bool cfg = config_sw_state();
+
          for (;;) {
-             led_state_machine_tick(uptime_millis());
+             fault_flash();
+             (void)system_sleep_fault();
+
+             if (irq_first_is(IRQ_EV_BUTTON) || gpio_door_sw_is_asserted() ||
+                 config_sw_state() != cfg)
+                 reboot();
          }
      }
 
@@ -144,9 +420,45 @@ static void reset_cause_debug_print(void)
      system_sleep_init();
      sei();
 
-     device_init();
+     /* Believed actuator states: warm RAM first, else EEPROM */
+     actuator_store_init();
+
+     uint8_t boot_states[DEVICE_ID_TABLE_SIZE];
+     bool    boot_locked = false;
+     bool    have_boot   = false;
+
+     if (warm_boot) {
+         memcpy(boot_states, warm.dev_state, sizeof(boot_states));
+         boot_locked = warm.lock_engaged;
+         have_boot   = true;
+     } else {
+         have_boot = actuator_store_load(boot_states, &boot_locked);
+     }
+
+     /* Closed without a completed lock pulse is not settled */
+     if (have_boot &&
+         boot_states[DEVICE_ID_DOOR] == DEV_STATE_OFF &&
+         !boot_locked)
+         boot_states[DEVICE_ID_DOOR] = DEV_STATE_UNKNOWN;
+
+     device_init(have_boot ? boot_states : NULL);
+
+     /* Believed lock position: an open door was unlocked to get there */
+     if (have_boot) {
+         if (boot_locked)
+             door_lock_restore(LOCK_STATE_LOCKED);
+         else if (boot_states[DEVICE_ID_DOOR] == DEV_STATE_ON)
+             door_lock_restore(LOCK_STATE_UNLOCKED);
+     }
      scheduler_init();
+     if (warm_boot)
+         scheduler_restore(&warm.sched);
      (void)config_load(&g_cfg);
+     event_log_init();
+
+     energy_wake_begin(ENERGY_WAKE_OTHER, uptime_millis());
+
+     input_init(on_input, uptime_millis());
 
      led_state_machine_set(LED_BLINK, LED_GREEN, 4);
 
@@ -162,9 +474,6 @@ static void reset_cause_debug_print(void)
 
      bool in_config_mode = false;
 
-     uint8_t  door_debounce_active   = 0;
-     uint32_t door_debounce_start_ms = 0;
-
      bool force_time_read = true;
 
      int cached_y = 0, cached_mo = 0, cached_d = 0;
@@ -172,31 +481,48 @@ static void reset_cause_debug_print(void)
 
      for (;;) {
 
+         mem_check();
+
          uint32_t now_ms = uptime_millis();
-         device_tick(now_ms);
+         timer_run(now_ms);
+         uint32_t dev_left = device_tick(now_ms);
+
+         {
+             uint8_t st[DEVICE_ID_TABLE_SIZE];
+             bool locked = settled_states(st);
+             actuator_store_update(st, locked);
+         }
+
+         ee_async_service();
+         metrics_service();
 
          /* ------------------------------------------------------
-          * CONFIG switch
+          * ISR events (button / CONFIG edges, RTC alarm), in order
           * ------------------------------------------------------ */
 
-         bool raw = config_sw_state();
+         irq_drain(&force_time_read);
 
-         if (raw != in_config_mode) {
+         /* ------------------------------------------------------
+          * CONFIG switch (debounced by the input engine)
+          * ------------------------------------------------------ */
 
-             _delay_ms(75);
+         bool cfg = input_level(INPUT_CONFIG_SW);
 
-             if (config_sw_state() == raw) {
+         if (cfg != in_config_mode) {
 
-                 in_config_mode = raw;
+             in_config_mode = cfg;
 
-                 if (in_config_mode) {
-                     console_init();
-                     reset_cause_debug_print();
-                 } else {
-                     mini_printf("Exiting console\n\n");
-                     console_flush();
-                     console_terminal_shutdown();
-                 }
+             if (in_config_mode) {
+                 energy_wake_begin(ENERGY_WAKE_CONFIG, uptime_millis());
+                 /* UART needs the fast clock for 38400 baud */
+                 clock_fast_acquire();
+                 console_init();
+                 reset_cause_debug_print();
+             } else {
+                 mini_printf(FSTR("Exiting console\n\n"));
+                 console_flush();
+                 console_terminal_shutdown();
+                 clock_fast_release();
              }
          }
 
@@ -204,40 +530,28 @@ static void reset_cause_debug_print(void)
              console_poll();
          }
 
-         /* ------------------------------------------------------
-          * Door ISR latch
-          * ------------------------------------------------------ */
-
-         if (g_door_event && !door_debounce_active) {
-             g_door_event = 0u;
-             door_debounce_active = 1u;
-             door_debounce_start_ms = now_ms;
-         }
-
-         if (door_debounce_active) {
-             if ((uint32_t)(now_ms - door_debounce_start_ms) >= 20u) {
-                 door_debounce_active = 0u;
-                 if (gpio_door_sw_is_asserted()) {
-                     door_sm_toggle();
-                 }
-             }
-         }
-
-         if (!gpio_door_sw_is_asserted() && !door_debounce_active) {
-             EIFR  |= (uint8_t)(1u << INTF1);
-             EIMSK |= (uint8_t)(1u << INT1);
-         }
-
          /* ------------------------------------------------------
           * RTC required
           * ------------------------------------------------------ */
 
+         rtc_osc_service(now_ms);
+
           if(rtc_time_is_set()) {
               if(!rtc_valid) rtc_valid = true;
           }
           else
          {
-             led_state_machine_set(LED_BLINK, LED_RED);
+             /* No time, no schedule: the console and the door
+                button above still work; otherwise wait in PWR_DOWN */
+             if (in_config_mode || sleep_blocked()) {
+                 led_state_machine_set(LED_BLINK, LED_RED);
+                 continue;
+             }
+
+             fault_flash();
+             sleep_bounded();
+
+             force_time_read = true;
              continue;
          }
 
@@ -290,8 +604,28 @@ static void reset_cause_debug_print(void)
 
                  have_sol = false;
 
-                 if (g_cfg.latitude_e4 != 0 ||
-                     g_cfg.longitude_e4 != 0) {
+                 /* Persist counters once per day (not on the boot read) */
+                 if (last_y != -1)
+                     metrics_snapshot();
+
+                 energy_day_rollover(cached_y, cached_mo, cached_d,
+                                     (uint32_t)cached_h * 3600ul +
+                                     (uint32_t)cached_m * 60ul +
+                                     (uint32_t)cached_s,
+                                     uptime_millis());
+
+                 if (warm_boot &&
+                     g_scheduler.have_sol &&
+                     g_scheduler.y  == cached_y &&
+                     g_scheduler.mo == cached_mo &&
+                     g_scheduler.d  == cached_d) {
+
+                     /* Same day as before the reset: reuse solar */
+                     sol      = g_scheduler.sol;
+                     have_sol = true;
+
+                 } else if (g_cfg.latitude_e4 != 0 ||
+                            g_cfg.longitude_e4 != 0) {
 
                      double lat = (double)g_cfg.latitude_e4  / 10000.0;
                      double lon = (double)g_cfg.longitude_e4 / 10000.0;
@@ -304,6 +638,9 @@ static void reset_cause_debug_print(void)
                                    cached_h))
                          tz += 1;
 
+                     /* Double-precision math: done on the fast clock */
+                     clock_fast_scope fast;
+
                      have_sol = solar_compute(
                          cached_y, cached_mo, cached_d,
                          lat, lon,
@@ -321,6 +658,8 @@ static void reset_cause_debug_print(void)
                  last_y  = cached_y;
                  last_mo = cached_mo;
                  last_d  = cached_d;
+
+                 warm_boot = false;
              }
 
              /* ---- Apply schedule ---- */
@@ -351,10 +690,20 @@ static void reset_cause_debug_print(void)
          if (in_config_mode)
              continue;
 
-         if (devices_busy() ||
-             door_debounce_active ||
-             g_door_event)
+         /* Device work pending (LED carrier, pulse): IDLE between
+            deadlines, never PWR_DOWN */
+         if (sleep_blocked() || dev_left != DEVICE_NO_DEADLINE) {
+             idle_until_deadline(dev_left);
              continue;
+         }
+
+         /* Oscillator not proven yet: bounded sleep, so a dead crystal
+            (whose alarm would never fire) is caught on the first wake */
+         if (rtc_osc_state() == RTC_OSC_UNVERIFIED) {
+             sleep_bounded();
+             force_time_read = true;
+             continue;
+         }
 
          uint16_t next_min;
          uint16_t wake_min;
@@ -365,20 +714,37 @@ static void reset_cause_debug_print(void)
              wake_min = next_minute(now_minute);
 
          (void)rtc_alarm_set_minute_of_day(wake_min);
+
+         warm_capture();
+         energy_wake_end(uptime_millis());
          system_sleep_until(wake_min);
 
          /* After wake, force time read next loop */
          force_time_read = true;
 
-         if (gpio_rtc_int_is_asserted())
-             rtc_alarm_clear_flag();
-
-         EIFR |= (uint8_t)((1u << INTF0) | (1u << INTF1));
-
-         if (!gpio_rtc_int_is_asserted())
-             EIMSK |= (uint8_t)(1u << INT0);
+         /* Wake cause: the first event queued by the sleep's ISR.
+            None if system_sleep_until() returned early on a line
+            that was already low (masked, so no ISR): use the pins */
+         struct irq_event wake;
+         bool have_wake = irq_queue_peek(&wake);
+
+         bool rtc_wake = have_wake ? (wake.type == IRQ_EV_RTC_ALARM)
+                                   : gpio_rtc_int_is_asserted();
+         bool btn_wake = have_wake ? (wake.type == IRQ_EV_BUTTON)
+                                   : gpio_door_sw_is_asserted();
+
+         if (rtc_wake) {
+             metric_inc(METRIC_WAKE_RTC);
+             energy_wake_begin(ENERGY_WAKE_RTC, uptime_millis());
+         } else if (btn_wake) {
+             metric_inc(METRIC_WAKE_BUTTON);
+             energy_wake_begin(ENERGY_WAKE_BUTTON, uptime_millis());
+         } else {
+             metric_inc(METRIC_WAKE_SPURIOUS);
+             energy_wake_begin(ENERGY_WAKE_OTHER, uptime_millis());
+         }
 
-         if (!gpio_door_sw_is_asserted())
-             EIMSK |= (uint8_t)(1u << INT1);
+         rtc_alarm_int_rearm();
+         input_hw_arm(INPUT_DOOR_SW);
      }
  }
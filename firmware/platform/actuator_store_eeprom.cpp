@@ -0,0 +1,181 @@
+/*
+ * actuator_store_eeprom.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Persisted actuator states (EEPROM ring)
+ *
+ * Notes:
+ *  - 4-byte records; the checksum is the last bytes written,
+ *    so a torn record never validates
+ *  - 32 slots: each slot sees 1/32 of the writes
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "actuator_store.h"
+#include "ee_async.h"
+#include "config.h"
+#include "devices/device.h"
+
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * EEPROM storage
+ * -------------------------------------------------------------------------- */
+
+#define ACT_SLOTS   32u
+
+struct act_rec {
+    uint8_t  seq;
+    uint8_t  packed;
+    uint16_t checksum;          /* Fletcher-16 over seq, packed */
+};
+
+static struct act_rec EEMEM ee_act[ACT_SLOTS];
+
+#define SEQ_EMPTY   0xFFu
+#define SEQ_MOD     255u
+
+/* Packed byte layout */
+#define PK_DOOR_SHIFT    0u
+#define PK_RELAY1_SHIFT  2u
+#define PK_RELAY2_SHIFT  4u
+#define PK_LOCK_BIT      (1u << 6)
+#define PK_STATE_MASK    0x03u
+
+/* --------------------------------------------------------------------------
+ * RAM state
+ * -------------------------------------------------------------------------- */
+
+static uint8_t g_head     = 0;      /* slot the next record goes into */
+static uint8_t g_next_seq = 0;
+static bool    g_have     = false;  /* g_last holds a stored record */
+static uint8_t g_last     = 0;
+
+/* --------------------------------------------------------------------------
+ * Helpers
+ * -------------------------------------------------------------------------- */
+
+static inline uint8_t seq_after(uint8_t s)
+{
+    return (uint8_t)((s + 1u) % SEQ_MOD);
+}
+
+static bool rec_read(uint8_t slot, struct act_rec *out)
+{
+    eeprom_read_block(out, &ee_act[slot], sizeof(*out));
+
+    if (out->seq == SEQ_EMPTY)
+        return false;
+
+    return out->checksum ==
+        config_fletcher16(out, offsetof(struct act_rec, checksum));
+}
+
+static uint8_t pack(const uint8_t *dev_state, bool locked)
+{
+    uint8_t p = 0;
+
+    p |= (uint8_t)((dev_state[DEVICE_ID_DOOR]   & PK_STATE_MASK) << PK_DOOR_SHIFT);
+    p |= (uint8_t)((dev_state[DEVICE_ID_RELAY1] & PK_STATE_MASK) << PK_RELAY1_SHIFT);
+    p |= (uint8_t)((dev_state[DEVICE_ID_RELAY2] & PK_STATE_MASK) << PK_RELAY2_SHIFT);
+
+    if (locked)
+        p |= PK_LOCK_BIT;
+
+    return p;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void actuator_store_init(void)
+{
+    g_head     = 0;
+    g_next_seq = 0;
+    g_have     = false;
+
+    uint8_t start = 0;
+    uint8_t prev  = eeprom_read_byte(&ee_act[0].seq);
+
+    if (prev == SEQ_EMPTY) {
+        prev = eeprom_read_byte(&ee_act[1].seq);
+
+        /* Fresh EEPROM */
+        if (prev == SEQ_EMPTY)
+            return;
+
+        /* Write torn at slot 0 after a wrap: the chain starts at 1
+           and its seq carries on (seq 0 would chain into old slots) */
+        start = 1;
+    }
+
+    /* Chain break = head */
+    uint8_t i;
+    for (i = (uint8_t)(start + 1u); i < ACT_SLOTS; i++) {
+        uint8_t s = eeprom_read_byte(&ee_act[i].seq);
+        if (s != seq_after(prev))
+            break;
+        prev = s;
+    }
+
+    g_head     = (uint8_t)(i % ACT_SLOTS);
+    g_next_seq = seq_after(prev);
+
+    /* Newest valid record (a torn newest falls back one) */
+    for (uint8_t n = 0; n < ACT_SLOTS; n++) {
+        uint8_t slot = (uint8_t)((g_head + ACT_SLOTS - 1u - n) % ACT_SLOTS);
+
+        struct act_rec r;
+        if (rec_read(slot, &r)) {
+            g_last = r.packed;
+            g_have = true;
+            break;
+        }
+    }
+}
+
+bool actuator_store_load(uint8_t *dev_state, bool *locked)
+{
+    if (!g_have || !dev_state)
+        return false;
+
+    memset(dev_state, DEV_STATE_UNKNOWN, DEVICE_ID_TABLE_SIZE);
+
+    dev_state[DEVICE_ID_DOOR]   = (uint8_t)((g_last >> PK_DOOR_SHIFT)   & PK_STATE_MASK);
+    dev_state[DEVICE_ID_RELAY1] = (uint8_t)((g_last >> PK_RELAY1_SHIFT) & PK_STATE_MASK);
+    dev_state[DEVICE_ID_RELAY2] = (uint8_t)((g_last >> PK_RELAY2_SHIFT) & PK_STATE_MASK);
+
+    if (locked)
+        *locked = (g_last & PK_LOCK_BIT) != 0;
+
+    return true;
+}
+
+void actuator_store_update(const uint8_t *dev_state, bool locked)
+{
+    if (!dev_state)
+        return;
+
+    uint8_t p = pack(dev_state, locked);
+
+    if (g_have && p == g_last)
+        return;
+
+    struct act_rec r;
+    r.seq      = g_next_seq;
+    r.packed   = p;
+    r.checksum = config_fletcher16(&r, offsetof(struct act_rec, checksum));
+
+    /* Queue full: try again next pass (ee_async copies the bytes) */
+    if (!ee_async_write(&ee_act[g_head], &r, sizeof(r)))
+        return;
+
+    g_last     = p;
+    g_have     = true;
+    g_head     = (uint8_t)((g_head + 1u) % ACT_SLOTS);
+    g_next_seq = seq_after(g_next_seq);
+}
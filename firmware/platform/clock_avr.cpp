@@ -0,0 +1,94 @@
+/*
+ * clock_avr.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Dynamic system clock scaling (ATmega1284P)
+ *
+ * Clock-dependent peripherals and how they follow the clock:
+ *  - Timer1 (uptime): prescaler 64 -> 8 keeps the 125 kHz tick
+ *  - USART0: UBRR recomputed (U2X on the slow clock)
+ *  - TWI: TWBR recomputed from the requested SCL (capped by F/16)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "clock.h"
+#include "uptime.h"
+#include "i2c.h"
+#include "uart.h"
+
+#include <avr/io.h>
+#include <avr/power.h>
+#include <avr/interrupt.h>
+#include <util/delay.h>
+
+static uint8_t g_shift      = 0;
+static uint8_t g_fast_depth = 0;
+
+/*
+ * Change the CPU clock and re-time every dependent peripheral
+ * before anything else runs on the new clock.
+ */
+static void clock_apply(uint8_t shift)
+{
+    if (shift == g_shift)
+        return;
+
+    /* Finish any byte in flight at the old baud rate */
+    uart_clock_prepare();
+
+    uint8_t sreg = SREG;
+    cli();
+
+    clock_prescale_set((shift == 0) ? clock_div_1 : clock_div_8);
+    g_shift = shift;
+
+    uptime_clock_changed(shift);
+    uart_clock_changed(clock_hz());
+    i2c_clock_changed(clock_hz());
+
+    SREG = sreg;
+}
+
+void clock_init(void)
+{
+    g_fast_depth = 0;
+    clock_apply(CLOCK_SLOW_SHIFT);
+}
+
+void clock_fast_acquire(void)
+{
+    if (g_fast_depth++ == 0)
+        clock_apply(0);
+}
+
+void clock_fast_release(void)
+{
+    if (g_fast_depth == 0)
+        return;
+
+    if (--g_fast_depth == 0)
+        clock_apply(CLOCK_SLOW_SHIFT);
+}
+
+uint32_t clock_hz(void)
+{
+    return (uint32_t)F_CPU >> g_shift;
+}
+
+uint8_t clock_shift(void)
+{
+    return g_shift;
+}
+
+void clock_delay_ms(uint16_t ms)
+{
+    /* Delay macros count F_CPU cycles: scale the constant, not the loop */
+    if (g_shift == 0) {
+        while (ms--)
+            _delay_ms(1);
+    } else {
+        while (ms--)
+            _delay_us(1000u >> CLOCK_SLOW_SHIFT);
+    }
+}
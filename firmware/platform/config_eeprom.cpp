@@ -10,13 +10,15 @@
  *  - EEPROM contents are untrusted
  *  - Config is self-describing (magic + version + checksum)
  *
- * Updated: 2026-01-05
+ * Updated: 2026-10-18
  */
 
 #include "config.h"
+#include "metrics.h"
 
 #include <avr/eeprom.h>
 #include <stddef.h>
+#include <string.h>
 
 /* --------------------------------------------------------------------------
  * EEPROM storage
@@ -25,6 +27,72 @@
 /* Single-slot EEPROM storage for full config */
 static struct config EEMEM ee_cfg;
 
+/* --------------------------------------------------------------------------
+ * Migration
+ * -------------------------------------------------------------------------- */
+
+/* v2: the v3 layout without the energy model */
+struct config_v2 {
+    uint32_t magic;
+    uint8_t  version;
+    uint8_t  _pad0[3];
+
+    int32_t  latitude_e4;
+    int32_t  longitude_e4;
+    int32_t  tz;
+    uint8_t  honor_dst;
+    uint32_t rtc_set_epoch;
+
+    uint16_t door_travel_ms;
+    uint16_t lock_pulse_ms;
+    uint16_t door_settle_ms;
+    uint16_t lock_settle_ms;
+
+    uint8_t  _pad1[2];
+
+    struct Event events[MAX_EVENTS];
+
+    uint16_t checksum;
+};
+
+/*
+ * Upgrade a valid v2 image in place: location, timing and the
+ * event table carry over, the energy model starts at defaults.
+ * The v3 image is written back, so this runs once.
+ */
+static bool config_migrate_v2(struct config *cfg)
+{
+    struct config_v2 old;
+
+    eeprom_read_block(&old, &ee_cfg, sizeof(old));
+
+    if (old.checksum != config_fletcher16(&old,
+                                          offsetof(struct config_v2, checksum)))
+        return false;
+
+    config_defaults(cfg);
+
+    cfg->latitude_e4    = old.latitude_e4;
+    cfg->longitude_e4   = old.longitude_e4;
+    cfg->tz             = old.tz;
+    cfg->honor_dst      = old.honor_dst;
+    cfg->rtc_set_epoch  = old.rtc_set_epoch;
+
+    cfg->door_travel_ms = old.door_travel_ms;
+    cfg->lock_pulse_ms  = old.lock_pulse_ms;
+    cfg->door_settle_ms = old.door_settle_ms;
+    cfg->lock_settle_ms = old.lock_settle_ms;
+
+    static_assert(sizeof(old.events) == sizeof(cfg->events),
+                  "event table layout changed: migrate it too");
+    memcpy(cfg->events, old.events, sizeof(cfg->events));
+
+    config_save(cfg);
+    config_seal(cfg);
+
+    return true;
+}
+
 /* --------------------------------------------------------------------------
  * Public API
  * -------------------------------------------------------------------------- */
@@ -36,11 +104,17 @@ bool config_load(struct config *cfg)
     /* Read raw config from EEPROM */
     eeprom_read_block(&tmp, &ee_cfg, sizeof(tmp));
 
+    /* Previous layout: carry it over */
+    if (tmp.magic == CONFIG_MAGIC && tmp.version == 2 &&
+        config_migrate_v2(cfg))
+        return true;
+
     /* Validate identity */
     if (tmp.magic != CONFIG_MAGIC ||
         tmp.version != CONFIG_VERSION) {
 
         /* Fresh EEPROM or incompatible layout */
+        metric_inc(METRIC_CONFIG_LOAD_FAIL);
         config_defaults(cfg);
         return false;
     }
@@ -54,6 +128,7 @@ bool config_load(struct config *cfg)
 
     if (stored != computed) {
         /* Corrupt EEPROM contents */
+        metric_inc(METRIC_CONFIG_LOAD_FAIL);
         config_defaults(cfg);
         return false;
     }
@@ -67,16 +142,8 @@ void config_save(const struct config *cfg)
 {
     struct config tmp = *cfg;
 
-    /* Ensure identity is correct */
-    tmp.magic   = CONFIG_MAGIC;
-    tmp.version = CONFIG_VERSION;
-
-    /* Compute checksum */
-    tmp.checksum = 0;
-    tmp.checksum = config_fletcher16(
-        &tmp,
-        offsetof(struct config, checksum)
-    );
+    /* Ensure identity is correct, compute checksum */
+    config_seal(&tmp);
 
     /* Write atomically */
     eeprom_update_block(&tmp, &ee_cfg, sizeof(tmp));
@@ -2,26 +2,27 @@
  * config_sw_avr.cpp
  *
  * Project: Chicken Coop Controller
- * Purpose: CONFIG slide switch (boot-time only)
+ * Purpose: CONFIG slide switch
  *
  * Notes:
  *  - Offline system
  *  - Deterministic behavior
  *  - No network dependencies
- *  - CONFIG is sampled once per boot and cached
  *
  * Hardware assumptions (LOCKED):
- *  - CONFIG slide switch is a static strap set BEFORE reset/power-up
+ *  - CONFIG slide switch; flipping it at run time enters / leaves
+ *    the console
  *
  * Electrical behavior (per schematic + verified):
  *  - Switch OPEN    → PC6 pulled HIGH → CONFIG MODE
  *  - Switch CLOSED  → PC6 tied to GND  → NORMAL MODE
  *
  * Firmware rules:
- *  - CONFIG is sampled once at boot and then ignored
- *  - CONFIG is NOT a wake source
+ *  - Read on demand (raw pin level)
+ *  - Edges are debounced by the input engine (input.h); its
+ *    pin-change interrupt also wakes PWR_DOWN
  *
- * Updated: 2026-01-16
+ * Updated: 2026-10-18
  */
 
 #include "config_sw.h"
@@ -29,7 +30,7 @@
 #include "gpio_avr.h"
 
 /*
- * Read CONFIG strap once at boot.
+ * Read the CONFIG switch.
  *
  * Returns:
  *   true  = CONFIG MODE active
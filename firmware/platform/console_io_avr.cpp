@@ -9,7 +9,7 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-18
  */
 
 #include "console/console_io.h"
@@ -25,6 +25,11 @@ void console_putc(char c)
     uart_putc(c);
 }
 
+void console_putc_raw(uint8_t b)
+{
+    uart_putc_raw(b);
+}
+
 void console_puts(const char *s)
 {
     while (*s)
@@ -9,7 +9,7 @@
  *  - LED2 (GREEN) -> PA1
  *
  * Notes:
- *  - Software PWM
+ *  - Software PWM; full duty is driven solid, without ticks
  *  - No timers owned
  *  - Deterministic, non-blocking
  */
@@ -19,6 +19,9 @@
 
 #include "door_led.h"
 #include "gpio_avr.h"
+#include "power.h"
+
+#include <avr/pgmspace.h>
 
 /* --------------------------------------------------------------------------
  * PWM state
@@ -28,6 +31,43 @@ static uint8_t pwm_red   = 0;
 static uint8_t pwm_green = 0;
 static uint8_t pwm_phase = 0;
 
+#define LED_PINS  ((uint8_t)((1u << LED_IN1_BIT) | (1u << LED_IN2_BIT)))
+
+/* Full-duty channel on, everything else off */
+static void drive_static(void)
+{
+    PORTA &= (uint8_t)~LED_PINS;
+
+    if (pwm_red == 255)
+        PORTA |= (1u << LED_IN1_BIT);
+    else if (pwm_green == 255)
+        PORTA |= (1u << LED_IN2_BIT);
+}
+
+/* --------------------------------------------------------------------------
+ * Sleep hooks
+ *
+ * Software PWM stops with the CPU; never sleep with an LED lit.
+ * Duties are kept: a solid channel is re-driven on wake (nothing
+ * ticks it), a PWM channel resumes with the next tick.
+ * -------------------------------------------------------------------------- */
+
+static void door_led_sleep_prepare(void)
+{
+    PORTA &= (uint8_t)~LED_PINS;
+}
+
+static void door_led_sleep_resume(void)
+{
+    drive_static();
+}
+
+static const char door_led_hook_name[] PROGMEM = "led";
+
+static const struct power_hooks door_led_hooks = {
+    door_led_hook_name, door_led_sleep_prepare, door_led_sleep_resume
+};
+
 /* --------------------------------------------------------------------------
  * Init
  * -------------------------------------------------------------------------- */
@@ -43,6 +83,8 @@ void door_led_init(void)
     pwm_red   = 0;
     pwm_green = 0;
     pwm_phase = 0;
+
+    (void)power_register(&door_led_hooks);
 }
 
 /* --------------------------------------------------------------------------
@@ -61,32 +103,42 @@ void door_led_red_pwm(uint8_t duty)
 {
     pwm_red   = duty;
     pwm_green = 0;
+
+    drive_static();
 }
 
 void door_led_green_pwm(uint8_t duty)
 {
     pwm_green = duty;
     pwm_red   = 0;
+
+    drive_static();
+}
+
+bool door_led_needs_tick(void)
+{
+    return (pwm_red   != 0 && pwm_red   != 255) ||
+           (pwm_green != 0 && pwm_green != 255);
 }
 
 /* --------------------------------------------------------------------------
  * PWM tick (call at fixed rate, e.g. 1 kHz)
  * -------------------------------------------------------------------------- */
- void door_led_tick(void)
+ void door_led_tick(uint8_t step)
  {
-     pwm_phase++;   /* wraps at 256 */
+     pwm_phase = (uint8_t)(pwm_phase + step);   /* wraps at 256 */
 
      /* FORCE BOTH LOW FIRST (this is the key fix) */
      PORTA &= ~((1u << LED_IN1_BIT) | (1u << LED_IN2_BIT));
 
      /* RED */
-     if (pwm_red && pwm_phase < pwm_red) {
+     if (pwm_red && (pwm_red == 255 || pwm_phase < pwm_red)) {
          PORTA |= (1u << LED_IN1_BIT);
          return;
      }
 
      /* GREEN */
-     if (pwm_green && pwm_phase < pwm_green) {
+     if (pwm_green && (pwm_green == 255 || pwm_phase < pwm_green)) {
          PORTA |= (1u << LED_IN2_BIT);
          return;
      }
@@ -19,8 +19,12 @@
  * -------------
  * This module is intentionally SIMPLE and DEFENSIVE.
  *
- *  - Blocking operation is REQUIRED and intentional
- *  - No timers, no interrupts, no background state
+ *  - Blocking pulses for manual overrides; the door sequence
+ *    uses a split pulse (start / finish) and waits in between
+ *  - Every pulse arms a Timer1 compare A cut-off at its on-time:
+ *    the only background activity, and it can only remove power
+ *  - Remembers the last completed direction so redundant
+ *    pulses are skipped (UNKNOWN until the first one)
  *  - No dependency on scheduler cadence or main loop health
  *
  * SAFETY GUARANTEES
@@ -44,16 +48,20 @@
  *  - H-bridge thermal failure
  *  - Board damage from software hangs
  *
- * Updated: 2026-02-03
+ * Updated: 2026-10-18
  */
 
 #include <avr/io.h>
-#include <util/delay.h>
+#include <avr/interrupt.h>
 #include <stdint.h>
 
 #include "door_lock.h"
 #include "gpio_avr.h"
 #include "config.h"
+#include "energy.h"
+#include "clock.h"
+#include "warm_state.h"
+#include "uptime.h"
 
 /*
  * HARD SAFETY LIMIT (milliseconds)
@@ -66,6 +74,15 @@
  */
 #define LOCK_MAX_PULSE_MS  1500u
 
+/* Settle after a release, sanity cap */
+#define LOCK_MAX_SETTLE_MS 2000u
+
+/* Believed position; UNKNOWN until a pulse completes */
+static door_lock_state_t g_lock_state = LOCK_STATE_UNKNOWN;
+
+/* Cut-off time of the pulse in progress (uptime ticks) */
+static volatile uint32_t g_cut_ticks = 0;
+
 /* --------------------------------------------------------------------------
  * Low-level helpers (masked writes only)
  * -------------------------------------------------------------------------- */
@@ -82,6 +99,56 @@ static inline void clear_bits(uint8_t mask)
     PORTA &= (uint8_t)~mask;
 }
 
+/* --------------------------------------------------------------------------
+ * Hardware cut-off (Timer1 compare A, shared timebase with uptime)
+ * -------------------------------------------------------------------------- */
+
+static void bridge_off(void)
+{
+    /* Power first, then direction */
+    clear_bits(1u << LOCK_EN_BIT);
+    clear_bits((1u << LOCK_INA_BIT) |
+               (1u << LOCK_INB_BIT));
+}
+
+/*
+ * Compare A matches the low 16 bits of the cut-off once per
+ * counter lap (524 ms); matches before the cut-off's own lap are
+ * ignored. From the cut-off on it stays armed and cuts again every
+ * lap until main context ends the pulse (door_lock_stop()), so a
+ * main-context PORTA write-back racing the first cut cannot leave
+ * the lock powered.
+ */
+ISR(TIMER1_COMPA_vect)
+{
+    if ((int32_t)(uptime_ticks() - g_cut_ticks) >= 0)
+        bridge_off();
+}
+
+static void cutoff_arm(uint16_t ms)
+{
+    uint8_t sreg = SREG;
+    cli();
+
+    g_cut_ticks = uptime_ticks() + (uint32_t)ms * (1000u / UPTIME_TICK_US);
+
+    OCR1A   = (uint16_t)g_cut_ticks;
+    TIFR1   = (1u << OCF1A);
+    TIMSK1 |= (1u << OCIE1A);
+
+    SREG = sreg;
+}
+
+static void cutoff_disarm(void)
+{
+    uint8_t sreg = SREG;
+    cli();
+
+    TIMSK1 &= (uint8_t)~(1u << OCIE1A);
+
+    SREG = sreg;
+}
+
 /* --------------------------------------------------------------------------
  * Public API
  * -------------------------------------------------------------------------- */
@@ -98,10 +165,12 @@ void door_lock_init(void)
 
     /* Force a known-safe state */
     door_lock_stop();
+
+    g_lock_state = LOCK_STATE_UNKNOWN;
 }
 
 /*
- * Internal helper: apply a blocking lock pulse in a given direction.
+ * Internal helper: start a lock pulse in a given direction.
  *
  * Parameters:
  *  - ina: desired logic level for INA
@@ -110,12 +179,16 @@ void door_lock_init(void)
  * This function:
  *  - Forces a clean OFF baseline
  *  - Applies direction
- *  - Enables power
- *  - Enforces a hard maximum on-time
- *  - Guarantees power is OFF on exit
+ *  - Arms the hard cut-off, then enables power
+ *
+ * Returns the on-time (ms), bounded by the hard maximum.
  */
-static void lock_pulse(uint8_t ina, uint8_t inb)
+static uint16_t pulse_on(uint8_t ina, uint8_t inb)
 {
+    /* Lock position is no longer known across a reset */
+    warm_state_invalidate();
+    g_lock_state = LOCK_STATE_UNKNOWN;
+
     /*
      * Defensive baseline:
      * Ensure the H-bridge is fully disabled before changing direction.
@@ -126,7 +199,7 @@ static void lock_pulse(uint8_t ina, uint8_t inb)
      * Small dead-time to allow bridge discharge and avoid
      * shoot-through on direction changes.
      */
-    _delay_ms(5);
+    clock_delay_ms(5);
 
     /* Apply direction (INA / INB) */
     if (ina)
@@ -148,29 +221,44 @@ static void lock_pulse(uint8_t ina, uint8_t inb)
         ms = LOCK_MAX_PULSE_MS;
 
     /*
-     * Enable power only after direction is stable
-     * and pulse duration is known.
+     * Enable power only after direction is stable,
+     * pulse duration is known and the cut-off is armed.
      */
+    cutoff_arm(ms);
     set_bits(1u << LOCK_EN_BIT);
 
+    energy_lock_pulse(ms);
+
+    return ms;
+}
+
+/*
+ * Internal helper: apply a blocking lock pulse.
+ * Guarantees power is OFF on exit.
+ */
+static void lock_pulse(uint8_t ina, uint8_t inb)
+{
+    uint16_t ms = pulse_on(ina, inb);
+
     /* Blocking delay: intentional and required for safety */
-    while (ms--)
-        _delay_ms(1);
+    clock_delay_ms(ms);
 
     /* Always shut down power before returning */
     door_lock_stop();
 }
 
-void door_lock_engage(void)
+void door_lock_engage_force(void)
 {
     /*
      * Engage direction:
      * INA = 1, INB = 0
      */
     lock_pulse(1, 0);
+
+    g_lock_state = LOCK_STATE_LOCKED;
 }
 
-void door_lock_release(void)
+void door_lock_release_force(void)
 {
     /*
      * Release direction:
@@ -179,27 +267,76 @@ void door_lock_release(void)
     lock_pulse(0, 1);
 
     /* Mechanical settle window */
+    clock_delay_ms(door_lock_settle_ms());
+
+    g_lock_state = LOCK_STATE_UNLOCKED;
+}
+
+uint16_t door_lock_pulse_start(door_lock_state_t target)
+{
+    if (g_lock_state == target)
+        return 0;
+
+    /* Engage: INA = 1, INB = 0. Release: INA = 0, INB = 1 */
+    if (target == LOCK_STATE_LOCKED)
+        return pulse_on(1, 0);
+
+    if (target == LOCK_STATE_UNLOCKED)
+        return pulse_on(0, 1);
+
+    return 0;
+}
+
+void door_lock_pulse_finish(door_lock_state_t target)
+{
+    /* Normally already cut by the compare interrupt */
+    door_lock_stop();
+
+    g_lock_state = target;
+}
+
+uint16_t door_lock_settle_ms(void)
+{
     uint16_t ms = g_cfg.lock_settle_ms;
-    if (ms > 2000)
-        ms = 2000;   /* sanity cap */
 
-    while (ms--)
-        _delay_ms(1);
+    return (ms > LOCK_MAX_SETTLE_MS) ? LOCK_MAX_SETTLE_MS : ms;
 }
 
-void door_lock_stop(void)
+void door_lock_engage(void)
 {
-    /*
-     * Kill power FIRST.
-     * This guarantees the motor is de-energized
-     * before changing or clearing direction.
-     */
-    clear_bits(1u << LOCK_EN_BIT);
+    if (g_lock_state == LOCK_STATE_LOCKED)
+        return;
+
+    door_lock_engage_force();
+}
+
+void door_lock_release(void)
+{
+    /* Already open, or reversing mid-travel: nothing to release */
+    if (g_lock_state == LOCK_STATE_UNLOCKED)
+        return;
+
+    door_lock_release_force();
+}
+
+door_lock_state_t door_lock_get_state(void)
+{
+    return g_lock_state;
+}
+
+void door_lock_restore(door_lock_state_t state)
+{
+    g_lock_state = state;
+}
 
+void door_lock_stop(void)
+{
     /*
-     * Then neutralize direction lines.
+     * Kill power FIRST, then neutralize direction lines.
      * Leaves the bridge in a passive, safe state.
      */
-    clear_bits((1u << LOCK_INA_BIT) |
-               (1u << LOCK_INB_BIT));
+    bridge_off();
+
+    /* Nothing left to cut */
+    cutoff_disarm();
 }
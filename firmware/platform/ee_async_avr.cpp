@@ -0,0 +1,94 @@
+/*
+ * ee_async_avr.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Deferred EEPROM byte writer (AVR implementation)
+ *
+ * Notes:
+ *  - Single-producer (main loop), single-consumer (main loop)
+ *  - No interrupts used; drained from ee_async_service()
+ *  - eeprom_update_byte() is only issued when EEPROM is ready,
+ *    so the caller never waits out a write cycle
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "ee_async.h"
+
+#include <avr/eeprom.h>
+#include <stdint.h>
+
+/* Queue depth in bytes (each entry: 16-bit address + data byte) */
+#define EE_ASYNC_DEPTH  48u
+
+struct ee_pending {
+    uint16_t addr;
+    uint8_t  data;
+};
+
+static struct ee_pending g_q[EE_ASYNC_DEPTH];
+static uint8_t g_head  = 0;     /* next slot to write into queue */
+static uint8_t g_tail  = 0;     /* next slot to flush to EEPROM  */
+static uint8_t g_count = 0;
+
+bool ee_async_write(void *ee_dst, const void *src, uint8_t len)
+{
+    if (!ee_dst || !src)
+        return false;
+
+    if ((uint8_t)(EE_ASYNC_DEPTH - g_count) < len)
+        return false;
+
+    uint16_t addr = (uint16_t)(uintptr_t)ee_dst;
+    const uint8_t *p = (const uint8_t *)src;
+
+    for (uint8_t i = 0; i < len; i++) {
+        g_q[g_head].addr = (uint16_t)(addr + i);
+        g_q[g_head].data = p[i];
+
+        g_head++;
+        if (g_head >= EE_ASYNC_DEPTH)
+            g_head = 0;
+    }
+
+    g_count = (uint8_t)(g_count + len);
+    return true;
+}
+
+void ee_async_service(void)
+{
+    if (g_count == 0)
+        return;
+
+    /* A previous byte is still programming; try again next tick */
+    if (!eeprom_is_ready())
+        return;
+
+    const struct ee_pending *e = &g_q[g_tail];
+    eeprom_update_byte((uint8_t *)(uintptr_t)e->addr, e->data);
+
+    g_tail++;
+    if (g_tail >= EE_ASYNC_DEPTH)
+        g_tail = 0;
+
+    g_count--;
+}
+
+/*
+ * Also busy while the last byte is still programming:
+ * entering PWR_DOWN mid-write keeps the oscillator running
+ * until the write completes (datasheet, "EEPROM Write During
+ * Power-down Sleep Mode").
+ */
+bool ee_async_busy(void)
+{
+    return g_count != 0 || !eeprom_is_ready();
+}
+
+void ee_async_flush(void)
+{
+    while (g_count != 0)
+        ee_async_service();
+
+    eeprom_busy_wait();
+}
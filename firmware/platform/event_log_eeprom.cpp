@@ -0,0 +1,182 @@
+/*
+ * event_log_eeprom.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Persistent actuator audit log (EEPROM ring)
+ *
+ * Notes:
+ *  - EEPROM contents are untrusted
+ *  - Head is derived from the sequence chain, never stored
+ *  - Writes go through ee_async (non-blocking)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "event_log.h"
+#include "ee_async.h"
+#include "rtc.h"
+
+#include <avr/eeprom.h>
+#include <stddef.h>
+
+/* --------------------------------------------------------------------------
+ * EEPROM storage
+ * -------------------------------------------------------------------------- */
+
+static struct event_log_rec EEMEM ee_log[EVENT_LOG_SLOTS];
+
+#define SEQ_EMPTY   0xFFu
+#define SEQ_MOD     255u
+
+/* --------------------------------------------------------------------------
+ * RAM state
+ * -------------------------------------------------------------------------- */
+
+static uint16_t g_head     = 0;     /* slot the next record goes into */
+static uint16_t g_count    = 0;     /* valid records held */
+static uint8_t  g_next_seq = 0;
+static uint16_t g_dropped  = 0;
+
+/* --------------------------------------------------------------------------
+ * Helpers
+ * -------------------------------------------------------------------------- */
+
+static uint8_t slot_seq(uint16_t slot)
+{
+    return eeprom_read_byte(&ee_log[slot].seq);
+}
+
+static inline uint8_t seq_after(uint8_t s)
+{
+    return (uint8_t)((s + 1u) % SEQ_MOD);
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void event_log_init(void)
+{
+    g_head     = 0;
+    g_count    = 0;
+    g_next_seq = 0;
+
+    uint8_t prev = slot_seq(0);
+
+    if (prev == SEQ_EMPTY) {
+        /* Fresh EEPROM: empty log */
+        if (slot_seq(1) == SEQ_EMPTY)
+            return;
+
+        /* Append torn at slot 0 after a wrap: 1..N-1 hold the log */
+        g_count    = EVENT_LOG_SLOTS - 1u;
+        g_next_seq = seq_after(slot_seq(EVENT_LOG_SLOTS - 1u));
+        return;
+    }
+
+    /*
+     * Walk the chain until the sequence breaks.
+     * The break point is the head. An empty slot there is either
+     * a ring that never wrapped (empty after it too) or a torn
+     * append (the older records follow it); a torn slot is never
+     * counted.
+     */
+    uint16_t i;
+    for (i = 1; i < EVENT_LOG_SLOTS; i++) {
+        uint8_t s = slot_seq(i);
+
+        if (s != seq_after(prev)) {
+            if (s != SEQ_EMPTY)
+                g_count = EVENT_LOG_SLOTS;
+            else if (i + 1u < EVENT_LOG_SLOTS &&
+                     slot_seq((uint16_t)(i + 1u)) != SEQ_EMPTY)
+                g_count = EVENT_LOG_SLOTS - 1u;
+            else
+                g_count = i;
+            break;
+        }
+
+        prev = s;
+    }
+
+    if (i == EVENT_LOG_SLOTS) {
+        /* Unbroken chain across every slot: wrapped exactly at 0 */
+        g_count = EVENT_LOG_SLOTS;
+        i = 0;
+    }
+
+    g_head     = i;
+    g_next_seq = seq_after(prev);
+}
+
+bool event_log_append(uint8_t device_id,
+                      evlog_action_t action,
+                      evlog_source_t source)
+{
+    struct event_log_rec r;
+
+    r.epoch     = rtc_get_epoch();
+    r.device_id = device_id;
+    r.action    = (uint8_t)action;
+    r.source    = (uint8_t)source;
+    r.seq       = g_next_seq;
+
+    /*
+     * Invalidate the slot first, as its own write: after a wrap it
+     * still holds the oldest record's valid seq, which a torn write
+     * would otherwise leave over new fields. seq is the last member,
+     * so it is also the last byte of the record programmed.
+     */
+    static const uint8_t empty = SEQ_EMPTY;
+
+    if (!ee_async_write(&ee_log[g_head].seq, &empty, 1)) {
+        if (g_dropped != 0xFFFFu)
+            g_dropped++;
+        return false;
+    }
+
+    if (!ee_async_write(&ee_log[g_head], &r, sizeof(r))) {
+        /* Slot already invalidated: the oldest record is gone */
+        if (g_count == EVENT_LOG_SLOTS)
+            g_count--;
+
+        if (g_dropped != 0xFFFFu)
+            g_dropped++;
+        return false;
+    }
+
+    g_head++;
+    if (g_head >= EVENT_LOG_SLOTS)
+        g_head = 0;
+
+    if (g_count < EVENT_LOG_SLOTS)
+        g_count++;
+
+    g_next_seq = seq_after(g_next_seq);
+    return true;
+}
+
+uint16_t event_log_count(void)
+{
+    return g_count;
+}
+
+uint16_t event_log_dropped(void)
+{
+    return g_dropped;
+}
+
+bool event_log_read(uint16_t back, struct event_log_rec *out)
+{
+    if (!out || back >= g_count)
+        return false;
+
+    /* Records may still be queued; make EEPROM authoritative */
+    ee_async_flush();
+
+    uint16_t slot = (uint16_t)((g_head + EVENT_LOG_SLOTS - 1u - back)
+                               % EVENT_LOG_SLOTS);
+
+    eeprom_read_block(out, &ee_log[slot], sizeof(*out));
+    return true;
+}
@@ -22,7 +22,39 @@
  */
 
 #include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
+
 #include "gpio_avr.h"
+#include "power.h"
+
+#define ACTUATOR_PORTA_MASK \
+    ((1u << DOOR_INA_BIT) | (1u << DOOR_INB_BIT) | (1u << DOOR_EN_BIT) | \
+     (1u << LOCK_INA_BIT) | (1u << LOCK_INB_BIT) | (1u << LOCK_EN_BIT))
+
+#define RELAY_PORTD_MASK \
+    ((1u << RELAY1_SET_BIT) | (1u << RELAY1_RESET_BIT) | \
+     (1u << RELAY2_SET_BIT) | (1u << RELAY2_RESET_BIT))
+
+/* --------------------------------------------------------------------------
+ * Sleep hook
+ *
+ * Sleep is only entered when no device is busy, so every driver
+ * should already be off. Re-assert it anyway: an energized coil
+ * or bridge in PWR_DOWN would drain the battery unattended.
+ * -------------------------------------------------------------------------- */
+
+static void actuators_sleep_prepare(void)
+{
+    PORTA &= (uint8_t)~ACTUATOR_PORTA_MASK;
+    PORTD &= (uint8_t)~RELAY_PORTD_MASK;
+}
+
+static const char actuators_hook_name[] PROGMEM = "actuators";
+
+static const struct power_hooks actuators_hooks = {
+    actuators_hook_name, actuators_sleep_prepare, NULL
+};
 
 /* --------------------------------------------------------------------------
  * coop_gpio_init()
@@ -63,4 +95,6 @@ void coop_gpio_init(void)
                (1u << LOCK_EN_BIT)  |
                (1u << LED_IN1_BIT)  |
                (1u << LED_IN2_BIT));
+
+    (void)power_register(&actuators_hooks);
 }
@@ -24,6 +24,9 @@ extern "C" {
 
 bool i2c_init(uint32_t scl_hz);
 
+/* Recompute the bit rate after a CPU clock change (see clock.h) */
+void i2c_clock_changed(uint32_t cpu_hz);
+
 /* Register-style helpers (most devices, including PCF8523) */
 bool i2c_write(uint8_t addr7, uint8_t reg, const uint8_t *buf, uint8_t len);
 bool i2c_read(uint8_t addr7, uint8_t reg, uint8_t *buf, uint8_t len);
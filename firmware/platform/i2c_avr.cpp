@@ -14,9 +14,14 @@
  */
 
 #include "i2c.h"
+#include "energy.h"
+#include "metrics.h"
+#include "power.h"
+#include "clock.h"
 
 #include <avr/io.h>
 #include <util/delay.h>
+#include <avr/pgmspace.h>
 
 #ifndef F_CPU
 #error "F_CPU must be defined for i2c_avr.cpp"
@@ -34,6 +39,9 @@ static inline uint8_t twi_status(void)
 /* Timeouts are counted in simple spin loops, deterministic. */
 #define I2C_SPIN_LIMIT  5000u
 
+/* Set when a transaction failed by timeout rather than by bus status */
+static bool g_twi_timed_out = false;
+
 static bool twi_wait_twint(void)
 {
     for (uint16_t i = 0; i < I2C_SPIN_LIMIT; i++) {
@@ -41,9 +49,18 @@ static bool twi_wait_twint(void)
             return true;
         }
     }
+    g_twi_timed_out = true;
     return false;
 }
 
+/* Classify a failed transaction for the metrics registry */
+static bool twi_account(bool ok, metric_id_t fail, metric_id_t timeout)
+{
+    if (!ok)
+        metric_inc(g_twi_timed_out ? timeout : fail);
+    return ok;
+}
+
 static bool twi_start(void)
 {
     TWCR = (1 << TWINT) | (1 << TWSTA) | (1 << TWEN);
@@ -88,6 +105,50 @@ static bool twi_read_byte(uint8_t *out, bool ack)
     return true;
 }
 
+/* --------------------------------------------------------------------------
+ * Sleep hooks
+ *
+ * PRTWI resets the TWI; it is re-initialized from the saved bit rate.
+ * -------------------------------------------------------------------------- */
+
+static uint8_t  g_twbr   = 0;
+static uint32_t g_scl_hz = 0;
+
+/* SCL = CPU / (16 + 2*TWBR*prescaler); the CPU clock may be scaled */
+static uint8_t twi_bitrate(uint32_t cpu_hz, uint32_t scl_hz)
+{
+    uint32_t div = cpu_hz / scl_hz;
+
+    /* Requested rate above CPU/16: run as fast as the TWI allows */
+    if (div <= 16u) return 0;
+
+    uint32_t twbr = (div - 16u) / 2u;
+    if (twbr > 255u) twbr = 255u;
+
+    return (uint8_t)twbr;
+}
+
+static void i2c_sleep_prepare(void)
+{
+    TWCR = 0;
+    PRR0 |= _BV(PRTWI);
+}
+
+static void i2c_sleep_resume(void)
+{
+    PRR0 &= (uint8_t)~_BV(PRTWI);
+
+    TWSR &= ~((1 << TWPS0) | (1 << TWPS1));
+    TWBR = g_twbr;
+    TWCR = (1 << TWEN);
+}
+
+static const char i2c_hook_name[] PROGMEM = "i2c";
+
+static const struct power_hooks i2c_hooks = {
+    i2c_hook_name, i2c_sleep_prepare, i2c_sleep_resume
+};
+
 /* --------------------------------------------------------------------------
  * Public API
  * -------------------------------------------------------------------------- */
@@ -99,19 +160,33 @@ bool i2c_init(uint32_t scl_hz)
     /* Prescaler = 1 */
     TWSR &= ~((1 << TWPS0) | (1 << TWPS1));
 
-    /* TWBR calculation: SCL = F_CPU / (16 + 2*TWBR*prescaler) */
-    uint32_t twbr = ((uint32_t)F_CPU / scl_hz - 16u) / 2u;
-    if (twbr > 255u) twbr = 255u;
-
-    TWBR = (uint8_t)twbr;
+    g_scl_hz = scl_hz;
+    g_twbr   = twi_bitrate(clock_hz(), scl_hz);
+    TWBR     = g_twbr;
 
     /* Enable TWI */
     TWCR = (1 << TWEN);
 
+    (void)power_register(&i2c_hooks);
+
     return true;
 }
 
-bool i2c_ping(uint8_t addr7)
+void i2c_clock_changed(uint32_t cpu_hz)
+{
+    if (g_scl_hz == 0) return;
+
+    /* Takes effect on the next transfer; resume hook reuses g_twbr */
+    g_twbr = twi_bitrate(cpu_hz, g_scl_hz);
+    if (!(PRR0 & _BV(PRTWI)))
+        TWBR = g_twbr;
+}
+
+/* --------------------------------------------------------------------------
+ * Transactions
+ * -------------------------------------------------------------------------- */
+
+static bool xfer_ping(uint8_t addr7)
 {
     if (!twi_start()) return false;
 
@@ -125,7 +200,7 @@ bool i2c_ping(uint8_t addr7)
     return ok;
 }
 
-bool i2c_write(uint8_t addr7, uint8_t reg, const uint8_t *buf, uint8_t len)
+static bool xfer_write(uint8_t addr7, uint8_t reg, const uint8_t *buf, uint8_t len)
 {
     if (!twi_start()) return false;
 
@@ -145,10 +220,8 @@ bool i2c_write(uint8_t addr7, uint8_t reg, const uint8_t *buf, uint8_t len)
     return true;
 }
 
-bool i2c_read(uint8_t addr7, uint8_t reg, uint8_t *buf, uint8_t len)
+static bool xfer_read(uint8_t addr7, uint8_t reg, uint8_t *buf, uint8_t len)
 {
-    if (len == 0) return true;
-
     /* Write register pointer */
     if (!twi_start()) return false;
 
@@ -181,3 +254,36 @@ bool i2c_read(uint8_t addr7, uint8_t reg, uint8_t *buf, uint8_t len)
     twi_stop();
     return true;
 }
+
+/* --------------------------------------------------------------------------
+ * Accounted entry points (energy ledger + metrics)
+ * -------------------------------------------------------------------------- */
+
+bool i2c_ping(uint8_t addr7)
+{
+    energy_i2c_xfer();
+    g_twi_timed_out = false;
+
+    return twi_account(xfer_ping(addr7),
+                       METRIC_I2C_PING_FAIL, METRIC_I2C_PING_TIMEOUT);
+}
+
+bool i2c_write(uint8_t addr7, uint8_t reg, const uint8_t *buf, uint8_t len)
+{
+    energy_i2c_xfer();
+    g_twi_timed_out = false;
+
+    return twi_account(xfer_write(addr7, reg, buf, len),
+                       METRIC_I2C_WRITE_FAIL, METRIC_I2C_WRITE_TIMEOUT);
+}
+
+bool i2c_read(uint8_t addr7, uint8_t reg, uint8_t *buf, uint8_t len)
+{
+    if (len == 0) return true;
+
+    energy_i2c_xfer();
+    g_twi_timed_out = false;
+
+    return twi_account(xfer_read(addr7, reg, buf, len),
+                       METRIC_I2C_READ_FAIL, METRIC_I2C_READ_TIMEOUT);
+}
@@ -0,0 +1,76 @@
+/*
+ * input_avr.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Input engine edge sources (see input.h)
+ *
+ * Hardware:
+ *  - DOOR_SW   → PD3 (INT1, low level; ISR in main_firmware.cpp)
+ *  - CONFIG_SW → PC6 (PCINT22, any edge)
+ *
+ * Notes:
+ *  - Each ISR masks its own source and queues one event; the
+ *    engine re-arms it once the input has settled, so a bouncing
+ *    contact costs one interrupt, not one per bounce
+ *  - PCINT22 also wakes PWR_DOWN: flipping CONFIG brings up the
+ *    console without waiting for the next alarm
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "input.h"
+#include "config_sw.h"
+#include "irq_queue.h"
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+
+#include "gpio_avr.h"
+
+ISR(PCINT2_vect)
+{
+    PCMSK2 &= (uint8_t)~(1u << CONFIG_SW_BIT);
+    (void)irq_queue_push(IRQ_EV_CONFIG_SW);
+}
+
+void input_hw_init(void)
+{
+    PCIFR  = (1u << PCIF2);
+    PCICR |= (1u << PCIE2);
+}
+
+bool input_hw_read(input_id_t id)
+{
+    switch (id) {
+    case INPUT_DOOR_SW:   return gpio_door_sw_is_asserted();
+    case INPUT_CONFIG_SW: return config_sw_state();
+    default:              return false;
+    }
+}
+
+void input_hw_arm(input_id_t id)
+{
+    uint8_t sreg = SREG;
+    cli();
+
+    switch (id) {
+
+    case INPUT_DOOR_SW:
+        /* Level triggered: arming while held would re-fire at once */
+        if (!gpio_door_sw_is_asserted()) {
+            EIFR  |= (uint8_t)(1u << INTF1);
+            EIMSK |= (uint8_t)(1u << INT1);
+        }
+        break;
+
+    case INPUT_CONFIG_SW:
+        PCIFR   = (1u << PCIF2);
+        PCMSK2 |= (uint8_t)(1u << CONFIG_SW_BIT);
+        break;
+
+    default:
+        break;
+    }
+
+    SREG = sreg;
+}
@@ -0,0 +1,129 @@
+/*
+ * macro_store_eeprom.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Console macros (EEPROM table)
+ *
+ * Notes:
+ *  - 128-byte records, 1 KB total
+ *  - The name is written last, so a torn define leaves either
+ *    the old record or an unnamed (empty) slot
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "macro_store.h"
+
+#include <avr/eeprom.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * EEPROM storage
+ * -------------------------------------------------------------------------- */
+
+struct macro_rec {
+    char name[MACRO_NAME_MAX + 1];
+    char body[MACRO_BODY_MAX + 1];
+};
+
+static struct macro_rec EEMEM ee_macros[MACRO_SLOTS];
+
+/* --------------------------------------------------------------------------
+ * Helpers
+ * -------------------------------------------------------------------------- */
+
+/* Slot name into out; false if empty or not a valid name */
+static bool slot_name(uint8_t slot, char *out)
+{
+    eeprom_read_block(out, ee_macros[slot].name, MACRO_NAME_MAX + 1);
+
+    for (uint8_t i = 0; i <= MACRO_NAME_MAX; i++) {
+        if (out[i] == '\0')
+            return i > 0;
+        if (out[i] <= ' ' || out[i] > '~')
+            return false;           /* erased (0xFF) or garbage */
+    }
+
+    return false;                   /* unterminated */
+}
+
+/* Slot holding name, or MACRO_SLOTS */
+static uint8_t find(const char *name)
+{
+    char buf[MACRO_NAME_MAX + 1];
+
+    for (uint8_t s = 0; s < MACRO_SLOTS; s++) {
+        if (slot_name(s, buf) && strcmp(buf, name) == 0)
+            return s;
+    }
+
+    return MACRO_SLOTS;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+bool macro_store_define(const char *name, const char *body)
+{
+    size_t nlen = strlen(name);
+    size_t blen = strlen(body);
+
+    if (nlen == 0 || nlen > MACRO_NAME_MAX ||
+        blen == 0 || blen > MACRO_BODY_MAX)
+        return false;
+
+    uint8_t slot = find(name);
+
+    if (slot == MACRO_SLOTS) {
+        char buf[MACRO_NAME_MAX + 1];
+
+        for (slot = 0; slot < MACRO_SLOTS; slot++) {
+            if (!slot_name(slot, buf))
+                break;
+        }
+
+        if (slot == MACRO_SLOTS)
+            return false;           /* table full */
+    }
+
+    /* Unname, write body, then name (torn write → empty slot) */
+    eeprom_update_byte((uint8_t *)ee_macros[slot].name, 0);
+    eeprom_update_block(body, ee_macros[slot].body, blen + 1);
+    eeprom_update_block(name, ee_macros[slot].name, nlen + 1);
+
+    return true;
+}
+
+bool macro_store_delete(const char *name)
+{
+    uint8_t slot = find(name);
+
+    if (slot == MACRO_SLOTS)
+        return false;
+
+    eeprom_update_byte((uint8_t *)ee_macros[slot].name, 0);
+    return true;
+}
+
+bool macro_store_read(const char *name, char *out)
+{
+    uint8_t slot = find(name);
+
+    if (slot == MACRO_SLOTS)
+        return false;
+
+    eeprom_read_block(out, ee_macros[slot].body, MACRO_BODY_MAX + 1);
+    out[MACRO_BODY_MAX] = '\0';
+
+    return true;
+}
+
+bool macro_store_name(uint8_t slot, char *out)
+{
+    if (slot >= MACRO_SLOTS)
+        return false;
+
+    return slot_name(slot, out);
+}
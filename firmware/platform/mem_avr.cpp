@@ -0,0 +1,128 @@
+/*
+ * mem_avr.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: SRAM usage and stack-depth monitoring (AVR implementation)
+ *
+ * Memory map (ATmega1284P, no heap):
+ *
+ *   RAMSTART  .data | .bss | .noinit | canary | painted ... | stack  RAMEND
+ *                                    ^__heap_start               ^SP
+ *
+ * Notes:
+ *  - Painting runs in .init3: SP is already set up (.init2),
+ *    .data/.bss are not initialized yet (.init4) but nothing
+ *    here touches them
+ *  - The trip path uses only registers and .noinit
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "mem.h"
+
+#include <avr/io.h>
+#include <avr/wdt.h>
+#include <avr/interrupt.h>
+#include <stdint.h>
+
+/* Linker-provided section boundaries */
+extern uint8_t __data_start;
+extern uint8_t __data_end;
+extern uint8_t __bss_start;
+extern uint8_t __bss_end;
+extern uint8_t __noinit_start;
+extern uint8_t __noinit_end;
+extern uint8_t __heap_start;
+
+#define MEM_PAINT         0xC5u
+#define MEM_CANARY_BYTES  8u
+
+#define MEM_TRIP_MAGIC    0x4D54u   /* 'MT' */
+
+/* --------------------------------------------------------------------------
+ * Reset-surviving trip record
+ * -------------------------------------------------------------------------- */
+
+static uint16_t g_trip_magic  __attribute__((section(".noinit")));
+static uint8_t  g_trip_reason __attribute__((section(".noinit")));
+
+static mem_trip_t g_last_trip = MEM_TRIP_NONE;
+
+/* --------------------------------------------------------------------------
+ * Stack painting (before main)
+ * -------------------------------------------------------------------------- */
+
+void mem_paint(void) __attribute__((naked, used, section(".init3")));
+
+void mem_paint(void)
+{
+    uint8_t *p = &__heap_start;
+
+    while (p < (uint8_t *)(uintptr_t)SP)
+        *p++ = MEM_PAINT;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void mem_init(void)
+{
+    if (g_trip_magic == MEM_TRIP_MAGIC)
+        g_last_trip = (mem_trip_t)g_trip_reason;
+    else
+        g_last_trip = MEM_TRIP_NONE;
+
+    g_trip_magic  = 0;
+    g_trip_reason = MEM_TRIP_NONE;
+}
+
+mem_trip_t mem_last_trip(void)
+{
+    return g_last_trip;
+}
+
+void mem_check(void)
+{
+    const uint8_t *p = &__heap_start;
+
+    for (uint8_t i = 0; i < MEM_CANARY_BYTES; i++) {
+        if (p[i] != MEM_PAINT) {
+
+            /* Stack has reached static data: nothing can be trusted */
+            cli();
+
+            g_trip_reason = MEM_TRIP_STACK_CANARY;
+            g_trip_magic  = MEM_TRIP_MAGIC;
+
+            /* Reset puts every actuator pin back to input (off) */
+            wdt_enable(WDTO_15MS);
+            for (;;) {
+            }
+        }
+    }
+}
+
+void mem_get_info(struct mem_info *out)
+{
+    if (!out)
+        return;
+
+    const uint8_t *bottom = &__heap_start + MEM_CANARY_BYTES;
+    const uint8_t *top    = (const uint8_t *)(RAMEND + 1u);
+    uint16_t sp           = SP;
+
+    /* First byte the stack has ever written */
+    const uint8_t *p = bottom;
+    while (p < top && *p == MEM_PAINT)
+        p++;
+
+    out->ram_total  = (uint16_t)(RAMEND + 1u - RAMSTART);
+    out->data       = (uint16_t)(&__data_end   - &__data_start);
+    out->bss        = (uint16_t)(&__bss_end    - &__bss_start);
+    out->noinit     = (uint16_t)(&__noinit_end - &__noinit_start);
+    out->stack_now  = (uint16_t)(RAMEND - sp);
+    out->stack_peak = (uint16_t)(top - p);
+    out->free_now   = (uint16_t)(sp + 1u - (uint16_t)(uintptr_t)&__heap_start);
+    out->free_min   = (uint16_t)(p - &__heap_start);
+}
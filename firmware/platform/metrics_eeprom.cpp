@@ -0,0 +1,186 @@
+/*
+ * metrics_eeprom.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Runtime metrics storage and EEPROM snapshot
+ *
+ * Notes:
+ *  - Two snapshot slots, written alternately; the newer valid
+ *    slot wins at boot, so a torn write loses at most one day
+ *  - Checksum is the last member and therefore the last byte
+ *    written
+ *  - Writes go through ee_async in small chunks (non-blocking)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "metrics.h"
+#include "ee_async.h"
+#include "config.h"
+
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * Counter storage
+ * -------------------------------------------------------------------------- */
+
+uint32_t g_metrics[METRIC_COUNT];
+
+/* --------------------------------------------------------------------------
+ * Names (flash)
+ * -------------------------------------------------------------------------- */
+
+#define METRIC_NAME_STR(id, name) \
+    static const char metric_##id##_name[] PROGMEM = name;
+
+METRICS_LIST(METRIC_NAME_STR)
+
+#undef METRIC_NAME_STR
+
+#define METRIC_NAME_PTR(id, name) metric_##id##_name,
+
+static const char *const metric_names[METRIC_COUNT] PROGMEM = {
+    METRICS_LIST(METRIC_NAME_PTR)
+};
+
+#undef METRIC_NAME_PTR
+
+const char *metric_name_P(uint8_t id)
+{
+    if (id >= METRIC_COUNT)
+        return NULL;
+
+    return (const char *)pgm_read_ptr(&metric_names[id]);
+}
+
+void metrics_clear(void)
+{
+    memset(g_metrics, 0, sizeof(g_metrics));
+}
+
+#if METRICS_SNAPSHOT
+
+/* --------------------------------------------------------------------------
+ * EEPROM snapshot
+ * -------------------------------------------------------------------------- */
+
+/* Layout identity: changes whenever the counter list does */
+#define METRICS_MAGIC   ((uint16_t)(0x4D00u | METRIC_COUNT))
+
+/* Bytes handed to ee_async per service call */
+#define METRICS_CHUNK   8u
+
+struct metrics_snap {
+    uint16_t magic;
+    uint16_t seq;
+    uint32_t v[METRIC_COUNT];
+    uint16_t checksum;          /* Fletcher-16 over all fields above */
+};
+
+static struct metrics_snap EEMEM ee_snap[2];
+
+static struct metrics_snap g_pending;
+static bool     g_pending_active = false;
+static uint8_t  g_pending_off    = 0;
+
+static uint8_t  g_next_slot = 0;
+static uint16_t g_seq       = 0;
+
+static bool snap_read(uint8_t slot, struct metrics_snap *out)
+{
+    eeprom_read_block(out, &ee_snap[slot], sizeof(*out));
+
+    if (out->magic != METRICS_MAGIC)
+        return false;
+
+    return out->checksum ==
+        config_fletcher16(out, offsetof(struct metrics_snap, checksum));
+}
+
+void metrics_init(void)
+{
+    struct metrics_snap a, b;
+
+    bool va = snap_read(0, &a);
+    bool vb = snap_read(1, &b);
+
+    const struct metrics_snap *use = NULL;
+    uint8_t used_slot = 0;
+
+    if (va && vb) {
+        /* Newer by wrapping sequence */
+        if ((int16_t)(b.seq - a.seq) > 0) {
+            use = &b;
+            used_slot = 1;
+        } else {
+            use = &a;
+        }
+    } else if (va) {
+        use = &a;
+    } else if (vb) {
+        use = &b;
+        used_slot = 1;
+    }
+
+    if (!use)
+        return;
+
+    memcpy(g_metrics, use->v, sizeof(g_metrics));
+    g_seq       = use->seq;
+    g_next_slot = (uint8_t)(used_slot ^ 1u);
+}
+
+void metrics_snapshot(void)
+{
+    /* Restarting over a half-written slot is fine: the other is intact */
+    g_pending.magic = METRICS_MAGIC;
+    g_pending.seq   = (uint16_t)(g_seq + 1u);
+    memcpy(g_pending.v, g_metrics, sizeof(g_pending.v));
+    g_pending.checksum =
+        config_fletcher16(&g_pending, offsetof(struct metrics_snap, checksum));
+
+    g_pending_off    = 0;
+    g_pending_active = true;
+}
+
+void metrics_service(void)
+{
+    if (!g_pending_active)
+        return;
+
+    uint8_t n = (uint8_t)(sizeof(g_pending) - g_pending_off);
+    if (n > METRICS_CHUNK)
+        n = METRICS_CHUNK;
+
+    uint8_t *dst = (uint8_t *)&ee_snap[g_next_slot] + g_pending_off;
+    const uint8_t *src = (const uint8_t *)&g_pending + g_pending_off;
+
+    /* Queue full: try again next pass */
+    if (!ee_async_write(dst, src, n))
+        return;
+
+    g_pending_off = (uint8_t)(g_pending_off + n);
+
+    if (g_pending_off >= sizeof(g_pending)) {
+        g_pending_active = false;
+        g_seq            = g_pending.seq;
+        g_next_slot     ^= 1u;
+    }
+}
+
+bool metrics_busy(void)
+{
+    return g_pending_active;
+}
+
+#else   /* !METRICS_SNAPSHOT */
+
+void metrics_init(void)     {}
+void metrics_snapshot(void) {}
+void metrics_service(void)  {}
+bool metrics_busy(void)     { return false; }
+
+#endif
@@ -0,0 +1,140 @@
+/*
+ * power_avr.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Power-reduction manager (ATmega1284P)
+ *
+ * Pin usage (see gpio_avr.h):
+ *  - PORTA : LED, door and lock H-bridges     (all driven)
+ *  - PORTB : unused (PB5..PB7 are ISP only)
+ *  - PORTC : PC0/PC1 TWI, PC6 CONFIG switch
+ *            PC2..PC5 JTAG (disabled at boot), PC7 unused
+ *  - PORTD : PD0/PD1 USART0, PD2 RTC INT, PD3 door button,
+ *            PD4..PD7 relays                   (all used)
+ *
+ * Peripherals in use:
+ *  - TWI, USART0, Timer1 (uptime)
+ *  - Everything else is gated in PRR at boot
+ *
+ * Updated: 2026-10-18
+ */
+
+#include <avr/io.h>
+#include <avr/pgmspace.h>
+#include <stddef.h>
+
+#include "power.h"
+#include "clock.h"
+#include "gpio_avr.h"
+#include "console/console.h"
+#include "console/mini_printf.h"
+
+/* Unused pins: input + pull-up (no floating CMOS inputs) */
+#define UNUSED_PORTB_MASK  0xFFu
+#define UNUSED_PORTC_MASK  (uint8_t)(_BV(PC2) | _BV(PC3) | _BV(PC4) | \
+                                     _BV(PC5) | _BV(PC7))
+
+/* --------------------------------------------------------------------------
+ * Hook table
+ * -------------------------------------------------------------------------- */
+
+static const struct power_hooks *g_hooks[POWER_MAX_HOOKS];
+static uint8_t g_hook_count = 0;
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void power_init(void)
+{
+    /* ADC off before gating its clock */
+    ADCSRA &= (uint8_t)~_BV(ADEN);
+
+    /* Analog comparator off, AIN0/AIN1 digital buffers off */
+    ACSR  |= _BV(ACD);
+    DIDR1 |= _BV(AIN1D) | _BV(AIN0D);
+
+    /* Never used in this firmware */
+    PRR0 |= _BV(PRADC) | _BV(PRSPI) | _BV(PRUSART1) |
+            _BV(PRTIM0) | _BV(PRTIM2);
+    PRR1 |= _BV(PRTIM3);
+
+    /* Unused pins: input with pull-up */
+    DDRB  &= (uint8_t)~UNUSED_PORTB_MASK;
+    PORTB |=  UNUSED_PORTB_MASK;
+
+    DDRC  &= (uint8_t)~UNUSED_PORTC_MASK;
+    PORTC |=  UNUSED_PORTC_MASK;
+}
+
+bool power_register(const struct power_hooks *h)
+{
+    if (!h)
+        return false;
+
+    for (uint8_t i = 0; i < g_hook_count; i++) {
+        if (g_hooks[i] == h)
+            return true;
+    }
+
+    if (g_hook_count >= POWER_MAX_HOOKS)
+        return false;
+
+    g_hooks[g_hook_count++] = h;
+    return true;
+}
+
+void power_sleep_prepare(void)
+{
+    for (uint8_t i = 0; i < g_hook_count; i++) {
+        if (g_hooks[i]->prepare)
+            g_hooks[i]->prepare();
+    }
+}
+
+void power_sleep_resume(void)
+{
+    for (uint8_t i = g_hook_count; i-- > 0; ) {
+        if (g_hooks[i]->resume)
+            g_hooks[i]->resume();
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Report
+ * -------------------------------------------------------------------------- */
+
+static void report_line(flash_str name, bool on)
+{
+    mini_printf(FSTR("%S: %S\n"), name, on ? FS(ON) : FSTR("off"));
+}
+
+void power_report(void)
+{
+    mini_printf(FSTR("CPU clock: %lu Hz\n"), (unsigned long)clock_hz());
+
+    report_line(FSTR("TWI     "), !(PRR0 & _BV(PRTWI)) && (TWCR & _BV(TWEN)));
+    report_line(FSTR("USART0  "), !(PRR0 & _BV(PRUSART0)) &&
+                            (UCSR0B & (_BV(RXEN0) | _BV(TXEN0))));
+    report_line(FSTR("USART1  "), !(PRR0 & _BV(PRUSART1)));
+    report_line(FSTR("SPI     "), !(PRR0 & _BV(PRSPI)));
+    report_line(FSTR("TIMER0  "), !(PRR0 & _BV(PRTIM0)));
+    report_line(FSTR("TIMER1  "), !(PRR0 & _BV(PRTIM1)));
+    report_line(FSTR("TIMER2  "), !(PRR0 & _BV(PRTIM2)));
+    report_line(FSTR("TIMER3  "), !(PRR1 & _BV(PRTIM3)));
+    report_line(FSTR("ADC     "), !(PRR0 & _BV(PRADC)) && (ADCSRA & _BV(ADEN)));
+    report_line(FSTR("AC      "), !(ACSR & _BV(ACD)));
+
+#if defined(BODS) && defined(BODSE)
+    console_puts(FSTR("BOD in sleep: disabled (BODS)\n"));
+#else
+    console_puts(FSTR("BOD in sleep: fuse setting\n"));
+#endif
+
+    mini_printf(FSTR("sleep hooks (%u):"), g_hook_count);
+    for (uint8_t i = 0; i < g_hook_count; i++) {
+        console_putc(' ');
+        console_puts_P(g_hooks[i]->name);
+    }
+    console_putc('\n');
+}
@@ -33,13 +33,15 @@
 #include "relay_hw.h"
 
 #include <avr/io.h>
-#include <util/delay.h>
 
 /* --------------------------------------------------------------------------
  * Configuration
  * -------------------------------------------------------------------------- */
 
 #include "gpio_avr.h"
+#include "energy.h"
+#include "clock.h"
+#include "warm_state.h"
 
 #define RELAY_PULSE_MS  20
 
@@ -72,6 +74,9 @@ void relay_init(void)
  */
 static inline void relay_pulse(uint8_t bit)
 {
+    /* Contact state is no longer known across a reset */
+    warm_state_invalidate();
+
     /* Enforce mutual exclusion: all relay coils OFF */
     PORTD &= ~RELAY_ALL_BITS;
 
@@ -79,10 +84,12 @@ static inline void relay_pulse(uint8_t bit)
     PORTD |= (1 << bit);
 
     /* Pulse width per relay datasheet */
-    _delay_ms(RELAY_PULSE_MS);
+    clock_delay_ms(RELAY_PULSE_MS);
 
     /* De-energize coil */
     PORTD &= ~(1 << bit);
+
+    energy_relay_pulse(RELAY_PULSE_MS);
 }
 
 /* --------------------------------------------------------------------------
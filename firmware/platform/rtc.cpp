@@ -64,10 +64,13 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <util/delay.h>
+#include <avr/io.h>
 
 #include "rtc.h"
 #include "i2c.h"
+#include "gpio_avr.h"
+#include "uptime.h"
+#include "metrics.h"
 #include "console/mini_printf.h"
 
 /* ============================================================================
@@ -126,45 +129,84 @@ static uint8_t bin_to_bcd(uint8_t v)
 
 
 /* ============================================================================
- * OSCILLATOR VALIDATION
+ * OSCILLATOR VALIDATION (background)
  * ========================================================================== */
 
-/**
- * Clear OS flag only if oscillator proven running.
+/*
+ * Boot trusts the RTC provisionally (STOP clear, OS clear). Proof
+ * that the crystal actually runs comes later, from the RTC's own
+ * seconds/minutes moving away from a reference sample.
  *
- * If OS is set:
- *   - Wait up to ~1.2 seconds for seconds rollover.
- *   - If advancing, clear OS.
- *   - If not advancing, leave OS set.
+ * Elapsed time for the verdict is awake uptime plus sleep time the
+ * caller can vouch for (rtc_osc_credit_ms). Time spent in an
+ * unbounded sleep never counts, so a long sleep cannot fake a stall.
  *
+ * OS flag: cleared only once the oscillator is proven running.
  * This prevents clearing OS during partial power collapse.
  */
-static void rtc_clear_os_if_running(void)
+
+#define RTC_OSC_PROOF_MS     1100u
+
+static rtc_osc_state_t g_osc_state  = RTC_OSC_UNVERIFIED;
+static uint8_t         g_osc_ref[2];        /* raw seconds, minutes */
+static bool            g_osc_ref_ok = false;
+static uint32_t        g_osc_ref_ms = 0;
+static uint32_t        g_osc_credit = 0;
+
+static void rtc_osc_begin(void)
 {
-    uint8_t sec1, sec2;
+    g_osc_state  = RTC_OSC_UNVERIFIED;
+    g_osc_credit = 0;
+    g_osc_ref_ms = uptime_millis();
+    g_osc_ref_ok = i2c_read(PCF8523_ADDR7, REG_SECONDS, g_osc_ref, 2);
+}
 
-    if (!i2c_read(PCF8523_ADDR7, REG_SECONDS, &sec1, 1))
+void rtc_osc_credit_ms(uint32_t ms)
+{
+    if (g_osc_state == RTC_OSC_UNVERIFIED)
+        g_osc_credit += ms;
+}
+
+void rtc_osc_service(uint32_t now_ms)
+{
+    if (g_osc_state != RTC_OSC_UNVERIFIED)
         return;
 
-    if ((sec1 & 0x80u) == 0u)
+    uint8_t cur[2];
+    if (!i2c_read(PCF8523_ADDR7, REG_SECONDS, cur, 2))
         return;
 
-    for (uint16_t i = 0; i < 1200u; i++) {
+    if (!g_osc_ref_ok) {
+        g_osc_ref[0] = cur[0];
+        g_osc_ref[1] = cur[1];
+        g_osc_ref_ok = true;
+        g_osc_ref_ms = now_ms;
+        return;
+    }
 
-        _delay_ms(1);
+    bool moved = ((cur[0] ^ g_osc_ref[0]) & 0x7Fu) != 0u ||
+                 ((cur[1] ^ g_osc_ref[1]) & 0x7Fu) != 0u;
 
-        if (!i2c_read(PCF8523_ADDR7, REG_SECONDS, &sec2, 1))
-            return;
+    if (moved) {
+        g_osc_state = RTC_OSC_VERIFIED;
 
-        if ((sec1 & 0x7Fu) != (sec2 & 0x7Fu))
-            break;
+        /* Proven running: a stale OS flag may go */
+        if (cur[0] & 0x80u) {
+            uint8_t sec = (uint8_t)(cur[0] & 0x7Fu);
+            (void)i2c_write(PCF8523_ADDR7, REG_SECONDS, &sec, 1);
+        }
+        return;
     }
 
-    if ((sec1 & 0x7Fu) == (sec2 & 0x7Fu))
-        return;
+    if ((uint32_t)(now_ms - g_osc_ref_ms) + g_osc_credit >= RTC_OSC_PROOF_MS) {
+        g_osc_state = RTC_OSC_STALLED;
+        metric_inc(METRIC_RTC_STALL);
+    }
+}
 
-    sec2 &= 0x7Fu;
-    (void)i2c_write(PCF8523_ADDR7, REG_SECONDS, &sec2, 1);
+rtc_osc_state_t rtc_osc_state(void)
+{
+    return g_osc_state;
 }
 
 /* ============================================================================
@@ -203,7 +245,7 @@ static void rtc_clear_os_if_running(void)
 
      // uint8_t verify;
      // if (i2c_read(PCF8523_ADDR7, REG_CONTROL_1, &verify, 1)) {
-     //     mini_printf("\tDEBUG RTC CTRL1 after init: 0x%02x\n", verify);
+     //     mini_printf(FSTR("\tDEBUG RTC CTRL1 after init: 0x%02x\n"), verify);
      // }
 
      /*
@@ -219,10 +261,11 @@ static void rtc_clear_os_if_running(void)
      }
 
      /*
-      * Clear alarm flag and validate oscillator-stop flag.
+      * Clear alarm flag. Oscillator proof (and OS flag clearing)
+      * runs in the background from here.
       */
      rtc_alarm_clear_flag();
-     rtc_clear_os_if_running();
+     rtc_osc_begin();
  }
 
 /* ============================================================================
@@ -240,10 +283,20 @@ bool rtc_oscillator_running(void)
 
 bool rtc_time_is_set(void)
 {
+    static bool os_seen = false;
+
     uint8_t sec;
     if (!i2c_read(PCF8523_ADDR7, REG_SECONDS, &sec, 1))
         return false;
-    return (sec & 0x80u) == 0u;
+
+    /* Count each time the OS flag newly appears, not every poll */
+    bool os = (sec & 0x80u) != 0u;
+    if (os && !os_seen)
+        metric_inc(METRIC_RTC_OSF);
+    os_seen = os;
+
+    /* A proven-stalled crystal invalidates the time as well */
+    return !os && g_osc_state != RTC_OSC_STALLED;
 }
 
 
@@ -265,17 +318,8 @@ bool rtc_validate_at_boot(void)
     if (sec1 & 0x80u)
         return false;
 
-    /* Prove it is ticking */
-    _delay_ms(1100);
-
-    uint8_t sec2;
-    if (!i2c_read(PCF8523_ADDR7, REG_SECONDS, &sec2, 1))
-        return false;
-
-    if ((sec2 & 0x7F) == (sec1 & 0x7F))
-        return false;   /* not advancing */
-
-    return true;
+    /* Provisional: motion is proven by rtc_osc_service() */
+    return g_osc_state != RTC_OSC_STALLED;
 }
 
 
@@ -292,7 +336,7 @@ void rtc_get_time(int *y, int *mo, int *d,
         return;
 
 #ifdef DEBUG_RTC
-    mini_printf("\tDEBUG RTC buffer: %02x %02x %02x %02x:\n", buf[0],  buf[1],  buf[2],  buf[3] );
+    mini_printf(FSTR("\tDEBUG RTC buffer: %02x %02x %02x %02x:\n"), buf[0],  buf[1],  buf[2],  buf[3] );
 #endif
 
     if (s)  *s  = bcd_to_bin(buf[0] & 0x7F);
@@ -345,7 +389,7 @@ bool rtc_set_time(int y, int mo, int d,
     buf[6] = bin_to_bcd((uint8_t)(y % 100));
 
     #ifdef DEBUG_RTC
-        mini_printf("\tDEBUG RTC buffer write : %02x %02x %02x %02x:\n",
+        mini_printf(FSTR("\tDEBUG RTC buffer write : %02x %02x %02x %02x:\n"),
                 buf[0], buf[1], buf[2], buf[3]);
     #endif
 
@@ -359,6 +403,9 @@ bool rtc_set_time(int y, int mo, int d,
     if (!i2c_write(PCF8523_ADDR7, REG_CONTROL_1, &c1, 1))
         return false;
 
+    /* Fresh start: prove motion again */
+    rtc_osc_begin();
+
     return true;
 }
 
@@ -421,3 +468,14 @@ void rtc_alarm_clear_flag(void)
     c2 &= (uint8_t)~CTRL2_AF_BIT;
     (void)i2c_write(PCF8523_ADDR7, REG_CONTROL_2, &c2, 1);
 }
+
+void rtc_alarm_int_rearm(void)
+{
+    if (gpio_rtc_int_is_asserted())
+        rtc_alarm_clear_flag();
+
+    if (!gpio_rtc_int_is_asserted()) {
+        EIFR  |= (uint8_t)(1u << INTF0);
+        EIMSK |= (uint8_t)(1u << INT0);
+    }
+}
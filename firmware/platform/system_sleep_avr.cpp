@@ -6,22 +6,40 @@
  *
  * Wake source:
  *   RTC INT → PD2 (INT0)
+ *   Door button → PD3 (INT1)
+ *   CONFIG switch → PC6 (PCINT22, armed by the input engine)
+ *   Fault mode only: watchdog interrupt, CONFIG switch always
+ *   IDLE only: Timer1 compare B (software timer deadline)
  *
  * Design:
  *  - No policy
  *  - No scheduling
  *  - No RTC interaction
- *  - No logging
+ *  - No logging (latency stamp only)
  *
- * Updated: 2026-02-08
+ * Updated: 2026-10-18
  */
 
 #include "system_sleep.h"
 #include <avr/io.h>
 #include <avr/sleep.h>
 #include <avr/interrupt.h>
+#include <avr/wdt.h>
 
 #include "gpio_avr.h"
+#include "latency.h"
+#include "power.h"
+#include "uptime.h"
+#include "irq_queue.h"
+
+/* Wake-only interrupt: the wake itself is the event
+   (PCINT2 belongs to the input engine, input_avr.cpp) */
+static volatile bool g_wdt_fired = false;
+
+ISR(WDT_vect)
+{
+    g_wdt_fired = true;
+}
 
 /*
  * Initialize RTC wake line (PD2 / INT0).
@@ -48,11 +66,16 @@
 
 /*
  * Enter PWR_DOWN until interrupt occurs.
+ *
+ * Drivers are quiesced through their power hooks first and
+ * restored after wake, whether or not the sleep happened.
  */
  void system_sleep_until(uint16_t minute)
  {
      (void)minute;
 
+     power_sleep_prepare();
+
      cli();
 
      /* Clear stale flags */
@@ -63,12 +86,25 @@
          gpio_door_sw_is_asserted())
      {
          sei();
+         power_sleep_resume();
          return;
      }
 
      set_sleep_mode(SLEEP_MODE_PWR_DOWN);
      sleep_enable();
 
+     /* Last stamp before the core stops (interrupts still off) */
+     latency_mark_sleep();
+
+     /*
+      * Timed sequence: BODS must be followed by SLEEP within
+      * 3 cycles. sei() guarantees the next instruction runs
+      * before any interrupt, so sleep_cpu() is reached in time.
+      */
+ #if defined(BODS) && defined(BODSE)
+     sleep_bod_disable();
+ #endif
+
      sei();
      sleep_cpu();
 
@@ -81,4 +117,110 @@
         Higher-level code decides when to re-arm. */
 
      sei();
+
+     power_sleep_resume();
  }
+
+
+/*
+ * Fault-mode wait: PWR_DOWN until the watchdog interrupt (~2 s),
+ * the door button or a CONFIG switch change.
+ *
+ * The WDT runs in interrupt mode only (WDE clear): its timeout
+ * wakes the core, it never resets it.
+ */
+ bool system_sleep_fault(void)
+ {
+     power_sleep_prepare();
+
+     cli();
+
+     g_wdt_fired = false;
+
+     /* RTC INT is not a wake source here */
+     uint8_t eimsk = EIMSK;
+     EIMSK &= (uint8_t)~(1u << INT0);
+     EIFR  |= (1u << INTF0) | (1u << INTF1);
+
+     /* CONFIG switch: any edge on PC6, armed or not by the engine */
+     uint8_t pcicr     = PCICR;
+     bool    cfg_armed = (PCMSK2 & (1u << CONFIG_SW_BIT)) != 0;
+
+     PCMSK2 |= (uint8_t)(1u << CONFIG_SW_BIT);
+     PCIFR   = (1u << PCIF2);
+     PCICR  |= (1u << PCIE2);
+
+     /* Timed sequence: interrupt mode, 2 s */
+     wdt_reset();
+     WDTCSR = (1u << WDCE) | (1u << WDE);
+     WDTCSR = (1u << WDIE) | (1u << WDP2) | (1u << WDP1) | (1u << WDP0);
+
+     if (!gpio_door_sw_is_asserted()) {
+
+         set_sleep_mode(SLEEP_MODE_PWR_DOWN);
+         sleep_enable();
+
+         latency_mark_sleep();
+
+ #if defined(BODS) && defined(BODSE)
+         sleep_bod_disable();
+ #endif
+
+         sei();
+         sleep_cpu();
+
+         cli();
+         sleep_disable();
+     }
+
+     wdt_disable();
+
+     /* Hand PCINT22 back as found (the ISR may have masked it) */
+     PCICR = pcicr;
+     if (!cfg_armed)
+         PCMSK2 &= (uint8_t)~(1u << CONFIG_SW_BIT);
+
+     /* Restore the RTC line as the caller left it */
+     EIFR  |= (1u << INTF0);
+     EIMSK |= (uint8_t)(eimsk & (1u << INT0));
+
+     sei();
+
+     power_sleep_resume();
+
+     return g_wdt_fired;
+ }
+
+
+/*
+ * IDLE until the next software timer deadline.
+ *
+ * Only the CPU clock stops; no power hooks, no latency stamp.
+ * The queue is checked with interrupts off: an event queued
+ * after the caller's checks either shows here or wakes the core.
+ */
+void system_sleep_idle_ms(uint32_t ms)
+{
+    if (ms == 0)
+        return;
+
+    if (ms > SYSTEM_SLEEP_IDLE_MAX_MS)
+        ms = SYSTEM_SLEEP_IDLE_MAX_MS;
+
+    cli();
+
+    if (!irq_queue_empty()) {
+        sei();
+        return;
+    }
+
+    uptime_alarm_arm((uint16_t)(ms * (1000u / UPTIME_TICK_US)));
+
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+
+    uptime_alarm_disarm();
+}
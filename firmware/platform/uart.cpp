@@ -7,24 +7,82 @@
  * Configuration:
  *   F_CPU = 8 MHz (internal RC)
  *   Baud  = 38400
- *   Mode  = Normal speed (16x)
+ *   Mode  = Normal speed (16x), double speed (8x) on the slow clock
  *   Frame = 8N1
+ *
+ * Notes:
+ *   - 38400 from 1 MHz is +8.5% off; the console holds the
+ *     fast clock (see clock.h) and the slow setting is best effort
  */
 
 #include "uart.h"
+#include "power.h"
+#include "clock.h"
 #include <avr/io.h>
+#include <avr/pgmspace.h>
 
 #define BAUD_RATE 38400UL
-#define UBRR_VALUE ((F_CPU / (16UL * BAUD_RATE)) - 1)
+
+/* Program UBRR for the given CPU clock */
+static void uart_set_baud(uint32_t cpu_hz)
+{
+    uint16_t ubrr;
+
+    if (cpu_hz >= F_CPU) {
+        /* Normal speed (U2X0 = 0) */
+        UCSR0A &= (uint8_t)~(1 << U2X0);
+        ubrr = (uint16_t)(cpu_hz / (16UL * BAUD_RATE) - 1);
+    } else {
+        UCSR0A |= (1 << U2X0);
+        ubrr = (uint16_t)((cpu_hz + 4UL * BAUD_RATE) / (8UL * BAUD_RATE) - 1);
+    }
+
+    UBRR0H = (uint8_t)(ubrr >> 8);
+    UBRR0L = (uint8_t)(ubrr & 0xFF);
+}
+
+/* A byte has been written since TXC0 was last cleared */
+static bool g_tx_used = false;
+
+/* Enabled state captured by the sleep hook */
+static bool g_was_enabled = false;
+
+static void uart_sleep_prepare(void)
+{
+    g_was_enabled = (UCSR0B & ((1 << RXEN0) | (1 << TXEN0))) != 0;
+
+    /* Let the last byte leave the shift register */
+    if (g_was_enabled && g_tx_used) {
+        while (!(UCSR0A & (1 << TXC0)))
+            ;
+    }
+
+    uart_shutdown();
+    PRR0 |= (1 << PRUSART0);
+}
+
+static void uart_sleep_resume(void)
+{
+    PRR0 &= (uint8_t)~(1 << PRUSART0);
+
+    if (g_was_enabled)
+        uart_init();
+}
+
+static const char uart_hook_name[] PROGMEM = "uart";
+
+static const struct power_hooks uart_hooks = {
+    uart_hook_name, uart_sleep_prepare, uart_sleep_resume
+};
 
 void uart_init(void)
 {
-    /* Normal speed (U2X0 = 0) */
+    PRR0 &= (uint8_t)~(1 << PRUSART0);
+
     UCSR0A = 0;
 
     /* Set baud rate */
-    UBRR0H = (uint8_t)(UBRR_VALUE >> 8);
-    UBRR0L = (uint8_t)(UBRR_VALUE & 0xFF);
+    uart_set_baud(clock_hz());
 
     /* Enable RX and TX */
     UCSR0B = (1 << RXEN0) | (1 << TXEN0);
@@ -38,6 +96,26 @@ void uart_init(void)
     while (UCSR0A & (1 << RXC0)) {
         (void)UDR0;
        }
+
+    g_tx_used = false;
+
+    (void)power_register(&uart_hooks);
+}
+
+void uart_clock_prepare(void)
+{
+    if ((UCSR0B & (1 << TXEN0)) && g_tx_used) {
+        while (!(UCSR0A & (1 << TXC0)))
+            ;
+    }
+}
+
+void uart_clock_changed(uint32_t cpu_hz)
+{
+    if (PRR0 & (1 << PRUSART0))
+        return;     /* uart_init() recomputes on resume */
+
+    uart_set_baud(cpu_hz);
 }
 
 void uart_shutdown(void)
@@ -71,10 +149,18 @@ void uart_putc(char c)
         UDR0 = '\r';
     }
 
+    uart_putc_raw((uint8_t)c);
+}
+
+void uart_putc_raw(uint8_t b)
+{
     while (!(UCSR0A & (1 << UDRE0)))
         ;
 
-    UDR0 = c;
+    /* Clear TXC0 so it marks completion of THIS byte */
+    UCSR0A |= (1 << TXC0);
+    UDR0 = b;
+    g_tx_used = true;
 }
 
 void uart_flush_tx(void)
@@ -13,9 +13,17 @@
  */
 
 #pragma once
+
+#include <stdint.h>
+
 void uart_init(void);
 void uart_shutdown(void);
 
 int  uart_getc(void);
-void uart_putc(char c);
+void uart_putc(char c);         /* '\n' → CR LF */
+void uart_putc_raw(uint8_t b);  /* no translation (binary) */
 void uart_flush_tx(void);
+
+/* CPU clock change (see clock.h): drain TX, then recompute UBRR */
+void uart_clock_prepare(void);
+void uart_clock_changed(uint32_t cpu_hz);
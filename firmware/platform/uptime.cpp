@@ -9,50 +9,172 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-18
  */
 
 #include "uptime.h"
+#include "clock.h"
+#include "irq_queue.h"
 
+#include <avr/io.h>
 #include <avr/interrupt.h>
 #include <stdint.h>
 
-// 1 kHz tick using Timer0 in CTC mode.
-// F_CPU = 8 MHz, prescaler = 64 -> 125 kHz timer clock.
-// OCR0A = 124 gives 1000 Hz.
+// Free-running Timer1, normal mode, overflow interrupt only.
+// F_CPU = 8 MHz, prescaler = 64 -> 125 kHz timer clock (8 us tick).
+// On the slow clock (F_CPU / 8) the prescaler drops to 8,
+// so the timer clock stays the same.
+//
+// The 16-bit counter overflows every 524.288 ms; the ISR extends
+// it to 48 bits (~71 years). Readers never disable interrupts.
+//
+// Timer1 keeps counting in IDLE sleep. In PWR_DOWN the I/O clock
+// stops and uptime pauses, as before.
 
-static volatile uint32_t g_millis = 0;
+#define UPTIME_TICKS_PER_MS  125u
 
-ISR(TIMER0_COMPA_vect)
+// Two back-to-back TCNT1 reads never differ by this much unless an
+// ISR reading TCNT1 clobbered the shared TEMP latch in between.
+#define UPTIME_READ_SLACK    64u
+
+static volatile uint32_t g_ovf = 0;     // bits 16..47 of the tick count
+
+ISR(TIMER1_OVF_vect)
+{
+    g_ovf++;
+}
+
+// Compare B: IDLE sleep until a timer deadline
+ISR(TIMER1_COMPB_vect)
+{
+    (void)irq_queue_push(IRQ_EV_IDLE_WAKE);
+}
+
+// Timer clock = F_CPU / 64 at any divider: the CPU divider
+// (1 << shift) times the Timer1 prescaler must come to 64
+static_assert(CLOCK_SLOW_SHIFT == 3 || CLOCK_SLOW_SHIFT == 6,
+              "CLOCK_SLOW_SHIFT needs a Timer1 prescaler of 64 >> shift");
+
+static uint8_t uptime_prescaler_bits(uint8_t shift)
+{
+    switch (shift) {
+    case 0:  return (uint8_t)((1 << CS11) | (1 << CS10));  // / 64
+    case 3:  return (uint8_t)(1 << CS11);                  // / 8
+    default: return (uint8_t)(1 << CS10);                  // / 1 (shift 6)
+    }
+}
+
+static uint16_t tcnt1_read(void)
 {
-    g_millis++;
+    for (;;) {
+        uint16_t a = TCNT1;
+        uint16_t b = TCNT1;
+
+        if ((uint16_t)(b - a) < UPTIME_READ_SLACK)
+            return b;
+    }
+}
+
+// Consistent 48-bit tick count without cli().
+// Also valid in ISR context, where the overflow ISR cannot run.
+static uint16_t uptime_ticks48(uint32_t *hi_out)
+{
+    uint32_t hi;
+    uint16_t lo;
+    uint8_t  pending;
+
+    do {
+        hi = g_ovf;
+        lo = tcnt1_read();
+
+        // Counter wrapped before the read, overflow ISR not run yet
+        pending = (TIFR1 & (1 << TOV1)) && lo < 0x8000u;
+
+    } while (hi != g_ovf);
+
+    *hi_out = hi + pending;
+    return lo;
 }
 
 void uptime_init(void)
 {
-    // CTC mode
-    TCCR0A = (1 << WGM01);
-    // prescaler 64
-    TCCR0B = (1 << CS01) | (1 << CS00);
-    // compare for 1 ms
-    OCR0A = 124;
-    // enable compare match interrupt
-    TIMSK0 |= (1 << OCIE0A);
+    PRR0 &= (uint8_t)~(1 << PRTIM1);
+
+    // Normal mode, counter from zero
+    TCCR1A = 0;
+    TCCR1B = 0;
+    TCNT1  = 0;
+    g_ovf  = 0;
+
+    TIFR1  = (1 << TOV1);
+    TIMSK1 = (1 << TOIE1);
+
+    // 125 kHz timer clock at the current CPU clock
+    TCCR1B = uptime_prescaler_bits(clock_shift());
 
     sei();
 }
 
-uint32_t uptime_millis(void)
+void uptime_clock_changed(uint8_t shift)
+{
+    TCCR1B = uptime_prescaler_bits(shift);
+}
+
+void uptime_alarm_arm(uint16_t ticks)
 {
-    uint32_t ms;
     uint8_t sreg = SREG;
     cli();
-    ms = g_millis;
+
+    OCR1B   = (uint16_t)(tcnt1_read() + ticks);
+    TIFR1   = (1 << OCF1B);
+    TIMSK1 |= (1 << OCIE1B);
+
     SREG = sreg;
-    return ms;
+}
+
+void uptime_alarm_disarm(void)
+{
+    TIMSK1 &= (uint8_t)~(1 << OCIE1B);
+}
+
+uint32_t uptime_ticks(void)
+{
+    uint32_t hi;
+    uint16_t lo = uptime_ticks48(&hi);
+
+    return (hi << 16) | lo;
+}
+
+uint32_t uptime_millis(void)
+{
+    uint32_t hi;
+    uint16_t lo = uptime_ticks48(&hi);
+
+    // (hi * 65536 + lo) / 125 in 32-bit steps; wraps like a counter
+    uint32_t q = hi / UPTIME_TICKS_PER_MS;
+    uint32_t r = hi % UPTIME_TICKS_PER_MS;
+
+    return (q << 16) + ((r << 16) + lo) / UPTIME_TICKS_PER_MS;
+}
+
+uint32_t uptime_micros(void)
+{
+    return uptime_ticks() * UPTIME_TICK_US;
 }
 
 uint32_t uptime_seconds(void)
 {
-    return uptime_millis() / 1000;
+    uint32_t hi;
+    uint16_t lo = uptime_ticks48(&hi);
+
+    // ms = q * 65536 + m, m < 65536 (q may exceed 32 bits' worth of ms)
+    uint32_t q = hi / UPTIME_TICKS_PER_MS;
+    uint32_t m = (((hi % UPTIME_TICKS_PER_MS) << 16) + lo) /
+                 UPTIME_TICKS_PER_MS;
+
+    // s = ms / 1000 = (q * 8192 + m / 8) / 125, split again on q
+    uint32_t a = q / 125u;
+    uint32_t b = q % 125u;
+
+    return (a << 13) + ((b << 13) + (m >> 3)) / 125u;
 }
@@ -0,0 +1,60 @@
+/*
+ * warm_state_avr.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Warm-reset state retention (ATmega1284P .noinit)
+ *
+ * Notes:
+ *  - .noinit is neither zeroed nor loaded by the C runtime
+ *  - Magic + Fletcher-16 over the whole record; the magic is
+ *    cleared first on invalidate, so a torn save never validates
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "warm_state.h"
+#include "config.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#define WARM_MAGIC  0x5753u     /* 'WS' */
+
+struct warm_record {
+    uint16_t          magic;
+    struct warm_state ws;
+    uint16_t          checksum;     /* over magic + ws */
+};
+
+static struct warm_record g_warm __attribute__((section(".noinit")));
+
+void warm_state_save(const struct warm_state *ws)
+{
+    if (!ws)
+        return;
+
+    g_warm.magic = 0;
+    memcpy(&g_warm.ws, ws, sizeof(g_warm.ws));
+    g_warm.magic = WARM_MAGIC;
+
+    g_warm.checksum =
+        config_fletcher16(&g_warm, offsetof(struct warm_record, checksum));
+}
+
+bool warm_state_load(struct warm_state *out)
+{
+    if (!out || g_warm.magic != WARM_MAGIC)
+        return false;
+
+    if (g_warm.checksum !=
+        config_fletcher16(&g_warm, offsetof(struct warm_record, checksum)))
+        return false;
+
+    memcpy(out, &g_warm.ws, sizeof(*out));
+    return true;
+}
+
+void warm_state_invalidate(void)
+{
+    g_warm.magic = 0;
+}
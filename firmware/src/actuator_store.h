@@ -0,0 +1,49 @@
+/*
+ * actuator_store.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Persisted actuator states (EEPROM, wear-leveled)
+ *
+ * Design:
+ *  - One byte of packed state per record: door, lock, relay1, relay2
+ *  - Records go round a small EEPROM ring; the newest is found
+ *    from the sequence chain at boot (same scheme as event_log)
+ *  - A record is written only when the packed state changes:
+ *    a completed relay pulse, a door reaching OPEN or CLOSED+locked,
+ *    and a door leaving a settled position (stored as UNKNOWN, so
+ *    power lost mid-travel re-drives on the next schedule)
+ *  - Boot restores the newest record as "believed" states
+ *
+ * Notes:
+ *  - EEPROM contents are untrusted (checksummed per record)
+ *  - Writes go through ee_async (non-blocking)
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "devices/device_ids.h"
+
+/* Scan the ring. Call once at boot, before actuator_store_load(). */
+void actuator_store_init(void);
+
+/*
+ * Believed states from the newest valid record.
+ *
+ * dev_state: DEVICE_ID_TABLE_SIZE entries (dev_state_t); devices
+ *            that are not persisted are set to UNKNOWN
+ * locked:    lock driven home at the time of the record
+ *
+ * Returns false if no valid record exists.
+ */
+bool actuator_store_load(uint8_t *dev_state, bool *locked);
+
+/*
+ * Record the current settled states if they differ from the
+ * last record. Cheap when nothing changed; call every pass.
+ */
+void actuator_store_update(const uint8_t *dev_state, bool locked);
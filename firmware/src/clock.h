@@ -0,0 +1,65 @@
+/*
+ * clock.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Dynamic system clock scaling (CLKPR)
+ *
+ * Design:
+ *  - Awake baseline is the SLOW clock (F_CPU / 8 = 1 MHz)
+ *  - Code that needs throughput (console I/O, solar math)
+ *    holds the FAST clock (F_CPU = 8 MHz) for as long as it needs it
+ *  - Requests nest; the clock drops back when the last holder releases
+ *  - Every change re-programs the clock-dependent peripherals
+ *    (uptime timer, USART0 baud, TWI bit rate) before returning
+ *
+ * Notes:
+ *  - F_CPU stays the FAST rate: it is what avr-libc delay macros
+ *    and compile-time constants assume. Use clock_delay_ms() for
+ *    any blocking wait that may run on the slow clock.
+ *  - USART0 at 38400 baud is only exact on the FAST clock
+ *  - Main context only
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* log2 of the slow-clock divider (8 MHz >> 3 = 1 MHz) */
+#define CLOCK_SLOW_SHIFT  3u
+
+/* Switch to the slow baseline. Called once at boot, before drivers init. */
+void clock_init(void);
+
+/* Hold / release the fast clock (nesting) */
+void clock_fast_acquire(void);
+void clock_fast_release(void);
+
+/* Current CPU clock */
+uint32_t clock_hz(void);
+
+/* log2 of the current divider: 0 (fast) or CLOCK_SLOW_SHIFT */
+uint8_t clock_shift(void);
+
+/*
+ * Blocking delay that is correct on either clock.
+ *
+ * Pure cycle counting (no timer, no interrupts), so it keeps
+ * the guarantees of the blocking actuator drivers.
+ */
+void clock_delay_ms(uint16_t ms);
+
+#ifdef __cplusplus
+
+/* Hold the fast clock for the enclosing scope */
+struct clock_fast_scope {
+    clock_fast_scope()  { clock_fast_acquire(); }
+    ~clock_fast_scope() { clock_fast_release(); }
+
+    clock_fast_scope(const clock_fast_scope &) = delete;
+    clock_fast_scope &operator=(const clock_fast_scope &) = delete;
+};
+
+#endif
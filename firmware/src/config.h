@@ -10,7 +10,7 @@
  *  - Self-describing configuration
  *  - Identical layout on host and AVR
  *
- * Updated: 2026-01-05
+ * Updated: 2026-10-18
  */
 
 #pragma once
@@ -21,7 +21,7 @@
 
 /* Config identity */
 #define CONFIG_MAGIC   0x434F4F50UL  /* 'COOP' */
-#define CONFIG_VERSION 2
+#define CONFIG_VERSION 3   /* v3: energy model */
 
 struct config {
     /* Identity */
@@ -42,6 +42,16 @@ struct config {
     uint16_t door_settle_ms;        /* delay after close before locking */
     uint16_t lock_settle_ms;       /* time after unlock before motion */
 
+    /* Energy model (battery-side currents, see energy.h) */
+    uint16_t batt_capacity_mah; /* usable battery capacity */
+    uint16_t sleep_ua;          /* PWR_DOWN baseline */
+    uint16_t awake_ua;          /* MCU running (RTC / button wake) */
+    uint16_t console_ua;        /* MCU running with console attached */
+    uint16_t i2c_nc;            /* charge per I2C transaction, nC */
+    uint16_t door_motor_ma;     /* door motor while driven */
+    uint16_t lock_ma;           /* lock actuator while pulsed */
+    uint16_t relay_ma;          /* latching relay coil while pulsed */
+
      uint8_t _pad1[2];           /* align events */
 
     /* Scheduler intent */
@@ -59,4 +69,7 @@ void config_defaults(struct config *cfg);
 /* Checksum helper */
 uint16_t config_fletcher16(const void *data, size_t len);
 
+/* Set magic, version and checksum in place */
+void config_seal(struct config *cfg);
+
 extern struct config g_cfg;
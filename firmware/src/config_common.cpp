@@ -9,7 +9,7 @@
  *  - Must not include AVR- or platform-specific headers
  *  - All fields initialized explicitly
  *
- * Updated: 2025-12-30
+ * Updated: 2026-10-18
  */
 
 #include "config.h"
@@ -35,6 +35,17 @@ uint16_t config_fletcher16(const void *data, size_t len)
     return (sum2 << 8) | sum1;
 }
 
+/*
+ * Stamp identity and checksum
+ * Makes a RAM image self-describing (EEPROM write, binary export)
+ */
+void config_seal(struct config *cfg)
+{
+    cfg->magic    = CONFIG_MAGIC;
+    cfg->version  = CONFIG_VERSION;
+    cfg->checksum = config_fletcher16(cfg, offsetof(struct config, checksum));
+}
+
 void config_defaults(struct config *cfg)
 {
     /* Start from a known baseline */
@@ -58,5 +69,16 @@ void config_defaults(struct config *cfg)
       cfg->door_settle_ms = 2000;   /* allow gravity + obstruction to clear */
       cfg->lock_settle_ms = 500;    /* time after unlock before motion */
 
+    /* ---- Energy model defaults (estimates, tune per build) ---- */
+
+    cfg->batt_capacity_mah = 7000;  /* 12 V 7 Ah SLA */
+    cfg->sleep_ua          = 60;    /* MCU PWR_DOWN + RTC + regulator Iq */
+    cfg->awake_ua          = 5000;  /* 8 MHz active */
+    cfg->console_ua        = 20000; /* active + USB-serial bridge */
+    cfg->i2c_nc            = 500;   /* ~0.5 ms at ~1 mA per transaction */
+    cfg->door_motor_ma     = 1500;
+    cfg->lock_ma           = 2000;
+    cfg->relay_ma          = 40;
+
     /* ---- Any future fields MUST be initialized here ---- */
 }
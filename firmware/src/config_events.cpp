@@ -18,7 +18,7 @@
  *  - scheduler_touch() is called whenever the event table changes
  *  - This invalidates any cached reductions or next-event results
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-18
  */
 
 #include "config_events.h"
@@ -178,3 +178,38 @@ void config_events_clear(void)
     /* Schedule definition changed */
     schedule_touch();
 }
+
+/* --------------------------------------------------------------------------
+ * Replace
+ * --------------------------------------------------------------------------
+ *
+ * Replaces the whole table (bulk provisioning).
+ *
+ * Behavior:
+ *  - Used slots must carry refnum == index + 1 (as add assigns)
+ *  - Unused slots (refnum 0) are copied as-is
+ *  - Table is left untouched on failure
+ *
+ * Scheduler impact:
+ *  - Entire schedule definition replaced
+ *  - MUST invalidate scheduler caches (once)
+ */
+bool config_events_replace(const Event *table)
+{
+    if (!table)
+        return false;
+
+    for (size_t i = 0; i < MAX_EVENTS; i++) {
+        if (table[i].refnum != 0 &&
+            table[i].refnum != (refnum_t)(i + 1))
+            return false;
+    }
+
+    for (size_t i = 0; i < MAX_EVENTS; i++)
+        g_cfg.events[i] = table[i];
+
+    /* Schedule definition changed */
+    schedule_touch();
+
+    return true;
+}
@@ -11,7 +11,7 @@
  *  - Callers must iterate 0..MAX_EVENTS-1 and skip unused slots
  *  - Scheduler treats the table as read-only
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-18
  * ========================================================================== */
 
 #pragma once
@@ -39,5 +39,8 @@ bool config_events_update_by_refnum(refnum_t ref,
                                     const Event *ev);    /* preserves refnum */
 bool config_events_delete_by_refnum(refnum_t ref);
 
+/* Whole table (MAX_EVENTS slots); used slots need refnum == index + 1 */
+bool config_events_replace(const Event *table);
+
 /* Utilities */
 void config_events_clear(void);
@@ -20,8 +20,8 @@
  * CONFIG slide switch state.
  *
  * Semantics:
- * - Sampled once per boot (firmware), cached in RAM.
+ * - Raw pin level, read on demand.
  * - Host build may stub/override.
- * - No debounce required (slide switch).
+ * - Raw level: debounced by the input engine (input.h).
  */
 bool config_sw_state(void);
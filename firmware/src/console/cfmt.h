@@ -0,0 +1,285 @@
+/*
+ * cfmt.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Compile-time checked console formatting
+ *
+ * Usage:
+ *
+ *   cfmt("tz   : %ld\n", g_cfg.tz);
+ *
+ * Design:
+ *  - The format is parsed by the compiler (constexpr), not at run
+ *    time: each call site expands to a fixed sequence of emit calls
+ *  - Argument count and types are checked against the conversions
+ *    with static_assert; a mismatch does not build
+ *  - The format text is stored once in flash (PROGMEM); literal
+ *    segments are streamed from there, nothing lands in SRAM
+ *  - Output goes straight to console_putc(), no buffer
+ *
+ * Conversions (same set as mini_printf, no '?' fallback):
+ *
+ *   %s    const char * (RAM) or flash_str
+ *   %c    char
+ *   %u    unsigned, fits unsigned int
+ *   %d    signed (or narrower unsigned), fits int
+ *   %lu   unsigned, fits unsigned long
+ *   %ld   signed (or narrower unsigned), fits long
+ *   %x    8-bit unsigned, two hex digits
+ *   %L    int32_t lat/lon e4 (DD.DDDD)
+ *   %%    literal %
+ *
+ *   Width / zero pad as mini_printf: %5u %02d %08lu
+ *
+ * Notes:
+ *  - "Fits int" is checked for the target: int32_t with %d is an
+ *    error on AVR (16-bit int), use %ld
+ *  - Format strings are limited to 255 characters
+ *  - No libstdc++ on AVR: the few traits needed are local
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+#include "console_io.h"
+
+/* Emitters shared with mini_printf (mini_printf.cpp) */
+void mini_put_uint(unsigned int v, unsigned int width, char pad);
+void mini_put_int(int v, unsigned int width, char pad);
+void mini_put_ulong(uint32_t v, unsigned int width, char pad);
+void mini_put_long(int32_t v, unsigned int width, char pad);
+void mini_put_latlon_e4(int32_t v);
+void mini_put_hex8(uint8_t v);
+
+/* Literal segment from flash */
+void mini_put_P(const char *p, uint8_t n);
+
+namespace cfmt_detail {
+
+/* ---------------------------------------------------------------------------
+ * Compile-time format parsing
+ * ------------------------------------------------------------------------- */
+
+/* One conversion, preceded by a literal segment of the format */
+struct op {
+    uint8_t lit_off;
+    uint8_t lit_len;
+    char    conv;       /* 's' 'c' 'u' 'd' 'x' 'L' '%', 0 = end, '?' = bad */
+    bool    is_long;
+    uint8_t width;
+    char    pad;
+};
+
+constexpr unsigned fmt_len(const char *s)
+{
+    unsigned n = 0;
+    while (s[n])
+        n++;
+    return n;
+}
+
+/* Parse op number idx; past the last conversion → end (conv 0) */
+constexpr op op_at(const char *s, unsigned idx)
+{
+    unsigned i   = 0;
+    unsigned lit = 0;
+
+    for (unsigned k = 0;; k++) {
+
+        lit = i;
+        while (s[i] && s[i] != '%')
+            i++;
+
+        op o = { (uint8_t)lit, (uint8_t)(i - lit), 0, false, 0, ' ' };
+
+        if (!s[i])
+            return o;                       /* end */
+
+        i++;                                /* skip '%' */
+
+        if (s[i] == '0') {
+            o.pad = '0';
+            i++;
+        }
+
+        while (s[i] >= '0' && s[i] <= '9') {
+            o.width = (uint8_t)(o.width * 10 + (s[i] - '0'));
+            i++;
+        }
+
+        if (s[i] == 'l') {
+            o.is_long = true;
+            i++;
+        }
+
+        switch (s[i]) {
+        case 's': case 'c': case 'u': case 'd':
+        case 'x': case 'L': case '%':
+            o.conv = s[i];
+            break;
+        default:
+            o.conv = '?';
+            break;
+        }
+
+        if (s[i])
+            i++;
+
+        if (k == idx)
+            return o;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Argument type rules
+ * ------------------------------------------------------------------------- */
+
+template <typename T> struct int_traits {
+    static constexpr bool ok = false;
+    static constexpr bool is_signed = false;
+};
+
+#define CFMT_INT_TRAITS(T, S)                               \
+    template <> struct int_traits<T> {                      \
+        static constexpr bool ok = true;                    \
+        static constexpr bool is_signed = S;                \
+    };
+
+CFMT_INT_TRAITS(signed char,        true)
+CFMT_INT_TRAITS(unsigned char,      false)
+CFMT_INT_TRAITS(short,              true)
+CFMT_INT_TRAITS(unsigned short,     false)
+CFMT_INT_TRAITS(int,                true)
+CFMT_INT_TRAITS(unsigned int,       false)
+CFMT_INT_TRAITS(long,               true)
+CFMT_INT_TRAITS(unsigned long,      false)
+
+#undef CFMT_INT_TRAITS
+
+template <typename A, typename B> struct same      { static constexpr bool v = false; };
+template <typename A>             struct same<A, A> { static constexpr bool v = true;  };
+
+template <typename T>
+constexpr bool arg_ok(op o)
+{
+    typedef int_traits<T> I;
+
+    const unsigned limit = o.is_long ? sizeof(long) : sizeof(int);
+
+    switch (o.conv) {
+    case 's':
+        return same<T, const char *>::v || same<T, char *>::v ||
+               same<T, flash_str>::v;
+    case 'c':
+        return same<T, char>::v;
+    case 'u':
+        return I::ok && !I::is_signed && sizeof(T) <= limit;
+    case 'd':
+        /* Narrower unsigned types convert without loss */
+        return I::ok && sizeof(T) <= limit &&
+               (I::is_signed || sizeof(T) < limit);
+    case 'x':
+        return I::ok && !I::is_signed && sizeof(T) == 1 && !o.is_long;
+    case 'L':
+        return same<T, int32_t>::v && !o.is_long;
+    default:
+        return false;
+    }
+}
+
+/* ---------------------------------------------------------------------------
+ * Emission (always inlined: a call site becomes a list of emit calls)
+ * ------------------------------------------------------------------------- */
+
+#define CFMT_INLINE  __attribute__((always_inline)) inline
+
+template <char C, bool L, uint8_t W, char P, typename T>
+CFMT_INLINE void put(T v)
+{
+    if constexpr (C == 's') {
+        console_puts(v);
+    } else if constexpr (C == 'c') {
+        console_putc(v);
+    } else if constexpr (C == 'u') {
+        if constexpr (L)
+            mini_put_ulong((uint32_t)v, W, P);
+        else
+            mini_put_uint((unsigned int)v, W, P);
+    } else if constexpr (C == 'd') {
+        if constexpr (L)
+            mini_put_long((int32_t)v, W, P);
+        else
+            mini_put_int((int)v, W, P);
+    } else if constexpr (C == 'x') {
+        mini_put_hex8(v);
+    } else {
+        mini_put_latlon_e4(v);
+    }
+}
+
+/* Arguments used up: only literals and %% may remain */
+template <typename F, unsigned I>
+CFMT_INLINE void emit(const char *fmt_P)
+{
+    constexpr op o = op_at(F::str(), I);
+
+    if (o.lit_len)
+        mini_put_P(fmt_P + o.lit_off, o.lit_len);
+
+    static_assert(o.conv != '?', "cfmt: unsupported conversion");
+    static_assert(o.conv == 0 || o.conv == '%',
+                  "cfmt: more conversions than arguments");
+
+    if constexpr (o.conv == '%') {
+        console_putc('%');
+        emit<F, I + 1>(fmt_P);
+    }
+}
+
+template <typename F, unsigned I, typename T, typename... Rest>
+CFMT_INLINE void emit(const char *fmt_P, T v, Rest... rest)
+{
+    constexpr op o = op_at(F::str(), I);
+
+    if (o.lit_len)
+        mini_put_P(fmt_P + o.lit_off, o.lit_len);
+
+    static_assert(o.conv != '?', "cfmt: unsupported conversion");
+    static_assert(o.conv != 0, "cfmt: more arguments than conversions");
+
+    if constexpr (o.conv == '%') {
+        console_putc('%');
+        emit<F, I + 1>(fmt_P, v, rest...);
+    } else {
+        static_assert(arg_ok<T>(o),
+                      "cfmt: argument type does not match conversion");
+
+        put<o.conv, o.is_long, o.width, o.pad>(v);
+        emit<F, I + 1>(fmt_P, rest...);
+    }
+}
+
+#undef CFMT_INLINE
+
+} // namespace cfmt_detail
+
+/*
+ * cfmt(fmt, args...)
+ *
+ * fmt must be a string literal. Arguments are passed by value
+ * (arrays decay to pointers).
+ */
+#define cfmt(fmt, ...)                                                      \
+    do {                                                                    \
+        struct cfmt_fmt_ {                                                  \
+            static constexpr const char *str() { return fmt; }              \
+        };                                                                  \
+        static_assert(::cfmt_detail::fmt_len(fmt) < 256,                    \
+                      "cfmt: format too long");                             \
+        static const char cfmt_fmt_P_[] PROGMEM = fmt;                      \
+        ::cfmt_detail::emit<cfmt_fmt_, 0>(cfmt_fmt_P_, ##__VA_ARGS__);      \
+    } while (0)
@@ -7,7 +7,8 @@
  * Features:
  *  - Interactive command-line interface over UART
  *  - Line editing (backspace, Ctrl-U)
- *  -
+ *  - ';'-separated command batches, one deferred save per batch
+ *  - STX "COOP" hands the UART to the binary protocol (console_bin.h)
  * Cross-platform notes:
  *  - Uses console_xxx_str() helpers from console.h
  *    → automatic PROGMEM handling on AVR
@@ -18,7 +19,7 @@
  *  - Fixed-size input buffer
  *  - Deterministic, offline operation
  *
- * Updated: January 2026
+ * Updated: 2026-10-18
  */
 
 
@@ -28,6 +29,7 @@
 #include "console.h"
 #include "console_io.h"
 #include "console/mini_printf.h"
+#include "console/console_bin.h"
 #include "console_time.h"
 #include "rtc.h"
 #include "uptime.h"
@@ -37,15 +39,22 @@
 
 
 extern void console_dispatch(int argc, char **argv);
+extern void console_batch_begin(void);
+extern void console_batch_end(void);
 extern struct config g_cfg;
 
-// Input buffer
-#define MAX_LINE 64
+// Input buffer (room for a ';' batch or a macro definition)
+#define MAX_LINE 128
 static char buf[MAX_LINE];
 static int idx = 0;
 
+// Binary protocol entry sequence
+static const char bin_magic[] PROGMEM = BIN_MAGIC;
+
 // Forward declaration of local helpers
 static void strip_comment(char *line);
+static void exec_command(char *cmd, bool raw_tail);
+static bool is_macro_def(const char *line);
 
 
 /**
@@ -57,9 +66,9 @@ void console_init(void)
 
     console_terminal_init();
 
-        console_puts("Chicken Coop Controller ");
+        console_puts(FS(BANNER));
         console_puts(PROJECT_VERSION);
-        console_puts("\n");
+        console_puts(FSTR("\n"));
 
     // Load configuration
     bool cfg_ok = config_load(&g_cfg);
@@ -81,8 +90,9 @@ void console_init(void)
 
     console_putc('\n');
 
-    // Reset input state
+    // Reset input state (new session starts in text mode)
     idx = 0;
+    console_bin_exit();
      console_puts_str(CONSOLE_STR("> "));
 }
 
@@ -93,14 +103,42 @@ void console_init(void)
  */
 void console_poll(void)
 {
-    static bool esc_active = false;
-    static bool esc_csi    = false;
+    static bool    esc_active = false;
+    static bool    esc_csi    = false;
+    static uint8_t magic_idx  = 0;
 
+    // ------------------------------------------------------------
+    // Binary provisioning session owns the UART
+    // ------------------------------------------------------------
+    if (console_bin_active()) {
+        if (!console_bin_poll())
+            console_puts_str(CONSOLE_STR("\n> "));
+        return;
+    }
 
     int c = console_getc();
     if (c < 0)
         return;
 
+    // ------------------------------------------------------------
+    // Binary protocol magic (STX "COOP"), swallowed like ESC
+    // ------------------------------------------------------------
+    if (magic_idx > 0) {
+        if (c == (int)pgm_read_byte(&bin_magic[magic_idx])) {
+            if (++magic_idx == sizeof(bin_magic) - 1) {
+                magic_idx = 0;
+                console_bin_enter();
+            }
+            return;
+        }
+        magic_idx = 0;      // not ours: handle c normally
+    }
+
+    if (c == (int)pgm_read_byte(&bin_magic[0])) {
+        magic_idx = 1;
+        return;
+    }
+
 
     // ------------------------------------------------------------
     // Swallow ANSI escape sequences (arrow keys, etc.)
@@ -140,20 +178,7 @@ void console_poll(void)
         console_putc('\n');
 
         buf[idx] = '\0';
-        strip_comment(buf);
-
-        char *argv[8];
-        int argc = 0;
-
-        char *p = strtok(buf, " ");
-        while (p && argc < 8) {
-            argv[argc++] = p;
-            p = strtok(NULL, " ");
-        }
-
-        if (argc > 0) {
-            console_dispatch(argc, argv);
-        }
+        console_exec_line(buf);
 
         idx = 0;
         console_puts_str(CONSOLE_STR("> "));
@@ -187,6 +212,87 @@ void console_poll(void)
     }
 }
 
+/**
+ * Run one console line: commands separated by ';'
+ *
+ * - The line is one batch: 'save' inside it is deferred to the
+ *   end, so the batch costs a single EEPROM commit
+ * - "macro def NAME ..." keeps the rest of the line (';' included)
+ *   as the macro body
+ * - Modifies line in place
+ */
+void console_exec_line(char *line)
+{
+    strip_comment(line);
+
+    console_batch_begin();
+
+    if (is_macro_def(line)) {
+        exec_command(line, true);
+    } else {
+        char *seg = line;
+
+        while (seg) {
+            char *next = strchr(seg, ';');
+            if (next)
+                *next++ = '\0';
+
+            exec_command(seg, false);
+            seg = next;
+        }
+    }
+
+    console_batch_end();
+}
+
+/**
+ * Tokenize and dispatch one command
+ * raw_tail: everything after the third word is one argument
+ */
+static void exec_command(char *cmd, bool raw_tail)
+{
+    char *argv[8];
+    int argc = 0;
+
+    char *p = strtok(cmd, " ");
+    while (p && argc < 8) {
+        argv[argc++] = p;
+
+        if (raw_tail && argc == 3) {
+            p = strtok(NULL, "");
+            while (p && *p == ' ')
+                p++;
+            if (p && *p)
+                argv[argc++] = p;
+            break;
+        }
+
+        p = strtok(NULL, " ");
+    }
+
+    if (argc > 0) {
+        console_dispatch(argc, argv);
+    }
+}
+
+/**
+ * Line starts with "macro def"
+ */
+static bool is_macro_def(const char *line)
+{
+    while (*line == ' ')
+        line++;
+
+    if (strncasecmp_P(line, PSTR("macro "), 6) != 0)
+        return false;
+
+    line += 6;
+    while (*line == ' ')
+        line++;
+
+    return strncmp_P(line, PSTR("def "), 4) == 0;
+}
+
 /**
  * Remove everything after # (simple comment support)
  */
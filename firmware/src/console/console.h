@@ -24,10 +24,15 @@
 #include <string.h>
 #include <avr/pgmspace.h>
 
+#include "console_io.h"
+
 // Core console lifecycle
 void console_init(void);
 void console_poll(void);
 
+// Run a ';'-separated command line (modified in place)
+void console_exec_line(char *line);
+
 // -----------------------------------------------------------------------------
 // Cross-platform string helpers for commands/help printing
 //
@@ -49,6 +54,7 @@ void console_poll(void);
 void console_putc(char c);
 void console_puts(const char *s);       // RAM version (host uses this directly)
 void console_puts_P(const char *s);     // PROGMEM version (firmware uses this)
+                                        // console_puts(flash_str): console_io.h
 
 int  console_getc(void);                // -1 if no character available
 
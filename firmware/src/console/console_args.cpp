@@ -0,0 +1,227 @@
+/*
+ * console_args.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Declarative console argument parsing (see console_args.h)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "console/console_args.h"
+
+#include <string.h>
+#include <avr/pgmspace.h>
+
+/* -------------------------------------------------------------------------- */
+/* Lexing                                                                     */
+/* -------------------------------------------------------------------------- */
+
+/* n decimal digits at s (no sign) */
+static bool digits(const char *s, uint8_t n, int32_t *out)
+{
+    int32_t v = 0;
+
+    for (uint8_t i = 0; i < n; i++) {
+        if (s[i] < '0' || s[i] > '9')
+            return false;
+        v = v * 10 + (s[i] - '0');
+    }
+
+    *out = v;
+    return true;
+}
+
+/* [+-]digits, whole string, |v| < 10^9 */
+static bool parse_int(const char *s, int32_t *out)
+{
+    bool neg = (*s == '-');
+
+    if (*s == '-' || *s == '+')
+        s++;
+
+    size_t n = strlen(s);
+
+    if (n == 0 || n > 9 || !digits(s, (uint8_t)n, out))
+        return false;
+
+    if (neg)
+        *out = -*out;
+    return true;
+}
+
+/* [+-]D[.DDDD]: extra fraction digits are truncated */
+static bool parse_e4(const char *s, int32_t *out)
+{
+    bool neg = (*s == '-');
+
+    if (*s == '-' || *s == '+')
+        s++;
+
+    const char *dot = strchr(s, '.');
+    size_t      ni  = dot ? (size_t)(dot - s) : strlen(s);
+    int32_t     ip;
+
+    if (ni == 0 || ni > 4 || !digits(s, (uint8_t)ni, &ip))
+        return false;
+
+    int32_t frac = 0;
+
+    if (dot) {
+        const char *f = dot + 1;
+
+        if (*f == '\0')
+            return false;
+
+        for (uint8_t i = 0; f[i]; i++) {
+            if (f[i] < '0' || f[i] > '9')
+                return false;
+        }
+
+        int32_t scale = 1000;
+        for (uint8_t i = 0; f[i] && i < 4; i++) {
+            frac += (f[i] - '0') * scale;
+            scale /= 10;
+        }
+    }
+
+    *out = ip * 10000L + frac;
+    if (neg)
+        *out = -*out;
+    return true;
+}
+
+static bool parse_hm(const char *s, int32_t *h, int32_t *m)
+{
+    return s[2] == ':' &&
+           digits(s, 2, h) && *h <= 23 &&
+           digits(s + 3, 2, m) && *m <= 59;
+}
+
+static bool is_leap_year(int32_t y)
+{
+    if ((y % 400) == 0) return true;
+    if ((y % 100) == 0) return false;
+    return (y % 4) == 0;
+}
+
+static int32_t days_in_month(int32_t y, int32_t mo)
+{
+    static const uint8_t dpm[12] PROGMEM =
+        {31,28,31,30,31,30,31,31,30,31,30,31};
+
+    if (mo == 2 && is_leap_year(y)) return 29;
+    return pgm_read_byte(&dpm[mo - 1]);
+}
+
+/* Index of s in a '|'-separated flash list, or -1 */
+static int32_t word_index(const char *words_P, const char *s)
+{
+    size_t  n   = strlen(s);
+    int32_t idx = 0;
+
+    for (;;) {
+        const char *w   = words_P;
+        size_t      len = 0;
+        char        c;
+
+        while ((c = (char)pgm_read_byte(w + len)) != '\0' && c != '|')
+            len++;
+
+        if (len == n && strncmp_P(s, w, n) == 0)
+            return idx;
+
+        if (c == '\0')
+            return -1;
+
+        words_P = w + len + 1;
+        idx++;
+    }
+}
+
+/* -------------------------------------------------------------------------- */
+/* Public API                                                                 */
+/* -------------------------------------------------------------------------- */
+
+bool arg_parse(const struct arg_spec *spec_P, const char *s, int32_t *out)
+{
+    struct arg_spec sp;
+    int32_t v, h, m, sec;
+
+    if (!s || !*s)
+        return false;
+
+    memcpy_P(&sp, spec_P, sizeof(sp));
+
+    switch (sp.kind) {
+
+    case ARG_INT:
+        if (!parse_int(s, &v) || v < sp.min || v > sp.max)
+            return false;
+        break;
+
+    case ARG_E4:
+        if (!parse_e4(s, &v) || v < sp.min || v > sp.max)
+            return false;
+        break;
+
+    case ARG_ENUM:
+        v = word_index(sp.words, s);
+        if (v < 0)
+            return false;
+        break;
+
+    case ARG_HHMM:
+        if (strlen(s) != 5 || !parse_hm(s, &h, &m))
+            return false;
+        v = h * 60 + m;
+        break;
+
+    case ARG_TIME: {
+        size_t n = strlen(s);
+
+        if ((n != 5 && n != 8) || !parse_hm(s, &h, &m))
+            return false;
+
+        sec = 0;
+        if (n == 8 &&
+            (s[5] != ':' || !digits(s + 6, 2, &sec) || sec > 59))
+            return false;
+
+        v = h * 3600L + m * 60L + sec;
+        break;
+    }
+
+    case ARG_DATE: {
+        int32_t y, mo, d;
+
+        if (strlen(s) != 10 || s[4] != '-' || s[7] != '-' ||
+            !digits(s, 4, &y) || !digits(s + 5, 2, &mo) ||
+            !digits(s + 8, 2, &d))
+            return false;
+
+        if (y < 2000 || y > 2099 || mo < 1 || mo > 12 ||
+            d < 1 || d > days_in_month(y, mo))
+            return false;
+
+        v = y * 10000L + mo * 100L + d;
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    *out = v;
+    return true;
+}
+
+bool args_parse(const struct arg_spec *spec_P, uint8_t n,
+                char *const *argv, int32_t *out)
+{
+    for (uint8_t i = 0; i < n; i++) {
+        if (!arg_parse(&spec_P[i], argv[i], &out[i]))
+            return false;
+    }
+
+    return true;
+}
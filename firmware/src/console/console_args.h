@@ -0,0 +1,75 @@
+/*
+ * console_args.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Declarative console argument parsing
+ *
+ * Design:
+ *  - A handler describes its arguments with arg_spec entries
+ *    (kind + range) kept in flash, instead of hand-written
+ *    strtol / strcmp chains
+ *  - Every kind parses to one int32_t, already range checked
+ *  - No floating point (lat/lon parse as fixed-point e4)
+ *
+ * Usage:
+ *
+ *   static const struct arg_spec spec[] PROGMEM = {
+ *       ARG_SPEC_INT(1, 255),
+ *   };
+ *   int32_t v[1];
+ *   if (!args_parse(spec, 1, &argv[2], v)) ...
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef enum : uint8_t {
+    ARG_INT = 0,    /* decimal integer in [min, max]                */
+    ARG_ENUM,       /* word from a "a|b|c" list (flash) → index     */
+    ARG_E4,         /* [+-]D[.DDDD] → value * 10^4 in [min, max]     */
+    ARG_HHMM,       /* HH:MM → minute of day                         */
+    ARG_TIME,       /* HH:MM or HH:MM:SS → second of day             */
+    ARG_DATE        /* YYYY-MM-DD, 2000..2099 → YYYYMMDD             */
+} arg_kind_t;
+
+struct arg_spec {
+    arg_kind_t  kind;
+    int32_t     min;
+    int32_t     max;
+    const char *words;      /* ARG_ENUM: '|'-separated list, PROGMEM */
+};
+
+#define ARG_SPEC_INT(lo, hi)  { ARG_INT,  (lo), (hi), NULL }
+#define ARG_SPEC_ENUM(words)  { ARG_ENUM, 0, 0, (words) }
+#define ARG_SPEC_E4(lo, hi)   { ARG_E4,   (lo), (hi), NULL }
+#define ARG_SPEC_HHMM         { ARG_HHMM, 0, 0, NULL }
+#define ARG_SPEC_TIME         { ARG_TIME, 0, 0, NULL }
+#define ARG_SPEC_DATE         { ARG_DATE, 0, 0, NULL }
+
+/* Parse s against one spec (spec in flash) */
+bool arg_parse(const struct arg_spec *spec_P, const char *s, int32_t *out);
+
+/* Parse argv[0..n-1] against n consecutive specs (flash) */
+bool args_parse(const struct arg_spec *spec_P, uint8_t n,
+                char *const *argv, int32_t *out);
+
+/* ARG_DATE value → calendar date */
+static inline void arg_date(int32_t v, int *y, int *mo, int *d)
+{
+    *y  = (int)(v / 10000);
+    *mo = (int)(v / 100 % 100);
+    *d  = (int)(v % 100);
+}
+
+/* ARG_TIME value → time of day */
+static inline void arg_time(int32_t v, int *h, int *m, int *s)
+{
+    *h = (int)(v / 3600);
+    *m = (int)(v / 60 % 60);
+    *s = (int)(v % 60);
+}
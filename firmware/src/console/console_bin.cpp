@@ -0,0 +1,498 @@
+/*
+ * console_bin.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Binary provisioning protocol (see console_bin.h)
+ *
+ * Notes:
+ *  - Runs inside the config-switch session, main context only
+ *  - A frame is received in one blocking pass; at 38400 baud
+ *    the largest request is ~35 ms on the wire
+ *  - Writes go through the same paths as the text commands
+ *    (config_save, config_events_*, rtc_set_time)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include <string.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+
+#include "console/console_bin.h"
+#include "console/console_io.h"
+#include "config.h"
+#include "config_events.h"
+#include "devices/devices.h"
+#include "event_log.h"
+#include "metrics.h"
+#include "rtc.h"
+#include "scheduler.h"
+#include "uptime.h"
+
+static_assert(sizeof(struct config) <= BIN_RX_MAX,
+              "BIN_RX_MAX must hold a CONFIG_WRITE payload");
+static_assert(sizeof(Event) * MAX_EVENTS <= BIN_RX_MAX,
+              "BIN_RX_MAX must hold an EVENTS_WRITE payload");
+
+static bool     g_active  = false;
+static uint32_t g_last_ms = 0;          /* last complete frame */
+
+static uint8_t  g_rx[BIN_RX_MAX];
+static uint16_t g_tx_crc;
+
+static const char bin_version[] PROGMEM = PROJECT_VERSION;
+
+/* Log record on the wire: epoch, device, action, source */
+#define BIN_LOG_REC_SIZE  7u
+
+/* --------------------------------------------------------------------------
+ * Byte I/O
+ * -------------------------------------------------------------------------- */
+
+static inline uint16_t crc_update(uint16_t crc, uint8_t b)
+{
+    /* avr-libc "xmodem" is poly 0x1021 MSB-first; init 0xFFFF
+       gives CRC-16/CCITT-FALSE */
+    return _crc_xmodem_update(crc, b);
+}
+
+/* Next byte, or false after BIN_BYTE_TIMEOUT_MS of silence */
+static bool rx_byte(uint8_t *out)
+{
+    uint32_t t0 = uptime_millis();
+
+    for (;;) {
+        int c = console_getc();
+
+        if (c >= 0) {
+            *out = (uint8_t)c;
+            return true;
+        }
+
+        if ((uint32_t)(uptime_millis() - t0) >= BIN_BYTE_TIMEOUT_MS)
+            return false;
+    }
+}
+
+static void tx_byte(uint8_t b)
+{
+    g_tx_crc = crc_update(g_tx_crc, b);
+    console_putc_raw(b);
+}
+
+static void tx_u16(uint16_t v)
+{
+    tx_byte((uint8_t)v);
+    tx_byte((uint8_t)(v >> 8));
+}
+
+static void tx_u32(uint32_t v)
+{
+    tx_u16((uint16_t)v);
+    tx_u16((uint16_t)(v >> 16));
+}
+
+static void tx_block(const void *p, uint16_t n)
+{
+    const uint8_t *b = (const uint8_t *)p;
+
+    while (n--)
+        tx_byte(*b++);
+}
+
+/* Response header; len counts the payload AFTER the status byte */
+static void tx_begin(uint8_t cmd, bin_status_t st, uint16_t len)
+{
+    console_putc_raw(BIN_SOF);
+
+    g_tx_crc = 0xFFFF;
+    tx_byte((uint8_t)(cmd | BIN_RESPONSE));
+    tx_u16((uint16_t)(len + 1u));
+    tx_byte(st);
+}
+
+static void tx_end(void)
+{
+    uint16_t crc = g_tx_crc;
+
+    console_putc_raw((uint8_t)crc);
+    console_putc_raw((uint8_t)(crc >> 8));
+}
+
+static void tx_status(uint8_t cmd, bin_status_t st)
+{
+    tx_begin(cmd, st, 0);
+    tx_end();
+}
+
+static uint16_t rd_u16(const uint8_t *p)
+{
+    return (uint16_t)(p[0] | ((uint16_t)p[1] << 8));
+}
+
+static uint32_t rd_u32(const uint8_t *p)
+{
+    return (uint32_t)rd_u16(p) | ((uint32_t)rd_u16(p + 2) << 16);
+}
+
+/* --------------------------------------------------------------------------
+ * Validation
+ * -------------------------------------------------------------------------- */
+
+/* Used slots: stable refnum, registered device, known action and
+   reference, offset within one day */
+static bool events_valid(const Event *ev)
+{
+    for (uint8_t i = 0; i < MAX_EVENTS; i++) {
+
+        if (ev[i].refnum == 0)
+            continue;
+
+        flash_str name;
+
+        if (ev[i].refnum != (refnum_t)(i + 1) ||
+            !device_name(ev[i].device_id, &name) ||
+            ev[i].action > ACTION_ON ||
+            ev[i].when.ref > REF_SOLAR_CIV_SET ||
+            ev[i].when.offset_minutes < -1439 ||
+            ev[i].when.offset_minutes >  1439)
+            return false;
+    }
+
+    return true;
+}
+
+static bool config_valid(const struct config *c)
+{
+    if (c->magic != CONFIG_MAGIC || c->version != CONFIG_VERSION)
+        return false;
+
+    if (c->checksum !=
+        config_fletcher16(c, offsetof(struct config, checksum)))
+        return false;
+
+    if (c->latitude_e4  < -900000L  || c->latitude_e4  > 900000L ||
+        c->longitude_e4 < -1800000L || c->longitude_e4 > 1800000L ||
+        c->honor_dst > 1)
+        return false;
+
+    return events_valid(c->events);
+}
+
+/* --------------------------------------------------------------------------
+ * Commands
+ * -------------------------------------------------------------------------- */
+
+static void bin_hello(uint8_t cmd)
+{
+    uint8_t vlen = (uint8_t)strlen_P(bin_version);
+
+    tx_begin(cmd, BIN_ST_OK, (uint16_t)(6u + vlen));
+    tx_byte(BIN_PROTO_VERSION);
+    tx_byte(CONFIG_VERSION);
+    tx_u16(sizeof(struct config));
+    tx_byte(MAX_EVENTS);
+    tx_byte(sizeof(Event));
+
+    for (uint8_t i = 0; i < vlen; i++)
+        tx_byte(pgm_read_byte(&bin_version[i]));
+
+    tx_end();
+}
+
+static void bin_config_read(uint8_t cmd)
+{
+    struct config tmp = g_cfg;
+
+    config_seal(&tmp);
+
+    tx_begin(cmd, BIN_ST_OK, sizeof(tmp));
+    tx_block(&tmp, sizeof(tmp));
+    tx_end();
+}
+
+static void bin_config_write(uint8_t cmd, uint16_t len)
+{
+    struct config tmp;
+
+    if (len != sizeof(tmp)) {
+        tx_status(cmd, BIN_ST_LEN);
+        return;
+    }
+
+    memcpy(&tmp, g_rx, sizeof(tmp));
+
+    if (!config_valid(&tmp)) {
+        tx_status(cmd, BIN_ST_INVALID);
+        return;
+    }
+
+    g_cfg = tmp;
+    config_save(&g_cfg);
+
+    /* Location, time zone and events may all have changed */
+    scheduler_invalidate_solar();
+    schedule_touch();
+
+    tx_status(cmd, BIN_ST_OK);
+}
+
+static void bin_events_read(uint8_t cmd)
+{
+    const Event *ev = config_events_get(NULL);
+
+    tx_begin(cmd, BIN_ST_OK, sizeof(Event) * MAX_EVENTS);
+    tx_block(ev, sizeof(Event) * MAX_EVENTS);
+    tx_end();
+}
+
+static void bin_events_write(uint8_t cmd, uint16_t len)
+{
+    Event ev[MAX_EVENTS];
+
+    if (len != sizeof(ev)) {
+        tx_status(cmd, BIN_ST_LEN);
+        return;
+    }
+
+    memcpy(ev, g_rx, sizeof(ev));
+
+    if (!events_valid(ev) || !config_events_replace(ev)) {
+        tx_status(cmd, BIN_ST_INVALID);
+        return;
+    }
+
+    /* Persists the whole shadow, as 'save' does */
+    config_save(&g_cfg);
+
+    tx_status(cmd, BIN_ST_OK);
+}
+
+/*
+ * t_sof: uptime when the frame's first byte arrived. The host
+ * stamped epoch/ms just before sending, so everything since then
+ * is added; the RTC (1 s resolution) is then written exactly on
+ * the next whole second.
+ */
+static void bin_rtc_set(uint8_t cmd, uint16_t len, uint32_t t_sof)
+{
+    if (len != 6u) {
+        tx_status(cmd, BIN_ST_LEN);
+        return;
+    }
+
+    uint32_t epoch = rd_u32(&g_rx[0]);
+    uint16_t ms    = rd_u16(&g_rx[4]);
+
+    if (ms >= 1000u) {
+        tx_status(cmd, BIN_ST_INVALID);
+        return;
+    }
+
+    uint32_t t0      = uptime_millis();
+    uint32_t transit = t0 - t_sof;
+    uint32_t total   = (uint32_t)ms + transit;
+
+    epoch += total / 1000u;
+
+    uint16_t frac = (uint16_t)(total % 1000u);
+
+    if (frac) {
+        uint16_t wait = (uint16_t)(1000u - frac);
+
+        while ((uint32_t)(uptime_millis() - t0) < wait)
+            ;
+
+        epoch++;
+    }
+
+    int y, mo, d, h, m, s;
+    rtc_ymdhms_from_epoch(epoch, g_cfg.tz, g_cfg.honor_dst,
+                          &y, &mo, &d, &h, &m, &s);
+
+    if (!rtc_set_time(y, mo, d, h, m, s)) {
+        tx_status(cmd, BIN_ST_RTC);
+        return;
+    }
+
+    /* Drift baseline, as 'set time' records it */
+    g_cfg.rtc_set_epoch = epoch;
+    config_save(&g_cfg);
+
+    scheduler_invalidate_solar();
+
+    tx_begin(cmd, BIN_ST_OK, 6);
+    tx_u32(epoch);
+    tx_u16((uint16_t)transit);
+    tx_end();
+}
+
+static void bin_stats_read(uint8_t cmd)
+{
+    uint16_t len = 1;
+
+    for (uint8_t i = 0; i < METRIC_COUNT; i++)
+        len = (uint16_t)(len + 1u + strlen_P(metric_name_P(i)) + 4u);
+
+    tx_begin(cmd, BIN_ST_OK, len);
+    tx_byte(METRIC_COUNT);
+
+    for (uint8_t i = 0; i < METRIC_COUNT; i++) {
+        const char *name = metric_name_P(i);
+        uint8_t     n    = (uint8_t)strlen_P(name);
+
+        tx_byte(n);
+        while (n--)
+            tx_byte(pgm_read_byte(name++));
+
+        tx_u32(metric_get((metric_id_t)i));
+    }
+
+    tx_end();
+}
+
+static void bin_log_read(uint8_t cmd)
+{
+    uint16_t count = event_log_count();
+
+    tx_begin(cmd, BIN_ST_OK, (uint16_t)(4u + count * BIN_LOG_REC_SIZE));
+    tx_u16(count);
+    tx_u16(event_log_dropped());
+
+    for (uint16_t back = 0; back < count; back++) {
+        struct event_log_rec r;
+
+        /* Length is committed: a vanished record goes out as zeros */
+        if (!event_log_read(back, &r))
+            memset(&r, 0, sizeof(r));
+
+        tx_u32(r.epoch);
+        tx_byte(r.device_id);
+        tx_byte(r.action);
+        tx_byte(r.source);
+    }
+
+    tx_end();
+}
+
+static void bin_dispatch(uint8_t cmd, uint16_t len, uint32_t t_sof)
+{
+    /* Commands without a request payload */
+    switch (cmd) {
+    case BIN_CMD_HELLO:
+    case BIN_CMD_CONFIG_READ:
+    case BIN_CMD_EVENTS_READ:
+    case BIN_CMD_STATS_READ:
+    case BIN_CMD_LOG_READ:
+    case BIN_CMD_EXIT:
+        if (len != 0) {
+            tx_status(cmd, BIN_ST_LEN);
+            return;
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (cmd) {
+    case BIN_CMD_HELLO:        bin_hello(cmd);                 break;
+    case BIN_CMD_CONFIG_READ:  bin_config_read(cmd);           break;
+    case BIN_CMD_CONFIG_WRITE: bin_config_write(cmd, len);     break;
+    case BIN_CMD_EVENTS_READ:  bin_events_read(cmd);           break;
+    case BIN_CMD_EVENTS_WRITE: bin_events_write(cmd, len);     break;
+    case BIN_CMD_RTC_SET:      bin_rtc_set(cmd, len, t_sof);   break;
+    case BIN_CMD_STATS_READ:   bin_stats_read(cmd);            break;
+    case BIN_CMD_LOG_READ:     bin_log_read(cmd);              break;
+
+    case BIN_CMD_EXIT:
+        tx_status(cmd, BIN_ST_OK);
+        g_active = false;
+        break;
+
+    default:
+        tx_status(cmd, BIN_ST_CMD);
+        break;
+    }
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void console_bin_enter(void)
+{
+    g_active  = true;
+    g_last_ms = uptime_millis();
+}
+
+void console_bin_exit(void)
+{
+    g_active = false;
+}
+
+bool console_bin_active(void)
+{
+    return g_active;
+}
+
+bool console_bin_poll(void)
+{
+    if (!g_active)
+        return false;
+
+    int c = console_getc();
+
+    if (c < 0) {
+        if ((uint32_t)(uptime_millis() - g_last_ms) >= BIN_IDLE_MS)
+            g_active = false;
+        return g_active;
+    }
+
+    /* Anything between frames is noise: resync on SOF */
+    if ((uint8_t)c != BIN_SOF)
+        return true;
+
+    uint32_t t_sof = uptime_millis();
+
+    uint8_t  hdr[3];
+    uint16_t crc = 0xFFFF;
+
+    for (uint8_t i = 0; i < sizeof(hdr); i++) {
+        if (!rx_byte(&hdr[i]))
+            return true;                /* torn frame: drop */
+        crc = crc_update(crc, hdr[i]);
+    }
+
+    uint8_t  cmd = hdr[0];
+    uint16_t len = rd_u16(&hdr[1]);
+
+    /* Oversized: consume it anyway so the stream stays in sync */
+    bool fits = (len <= BIN_RX_MAX);
+
+    for (uint16_t i = 0; i < len; i++) {
+        uint8_t b;
+
+        if (!rx_byte(&b))
+            return true;
+        crc = crc_update(crc, b);
+
+        if (fits)
+            g_rx[i] = b;
+    }
+
+    uint8_t lo, hi;
+
+    if (!rx_byte(&lo) || !rx_byte(&hi))
+        return true;
+
+    g_last_ms = uptime_millis();
+
+    if (crc != (uint16_t)(lo | ((uint16_t)hi << 8)))
+        tx_status(cmd, BIN_ST_CRC);
+    else if (!fits)
+        tx_status(cmd, BIN_ST_LEN);
+    else
+        bin_dispatch(cmd, len, t_sof);
+
+    return g_active;
+}
@@ -0,0 +1,118 @@
+/*
+ * console_bin.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Binary provisioning protocol on the console UART
+ *
+ * Design:
+ *  - Same UART, same config-switch session as the text console
+ *  - Entered from the text console by BIN_MAGIC; left with
+ *    BIN_CMD_EXIT or after BIN_IDLE_MS without a frame
+ *  - Host sends a request, device sends exactly one response
+ *  - Requests are buffered (max BIN_RX_MAX payload bytes);
+ *    responses are streamed from their source, no TX buffer
+ *
+ * Frame (both directions, little-endian):
+ *
+ *   0xA5 | cmd | len_lo len_hi | payload[len] | crc_lo crc_hi
+ *
+ *   crc: CRC-16/CCITT-FALSE (poly 0x1021, init 0xFFFF) over
+ *        cmd, len and payload
+ *
+ *   Response cmd = request cmd | 0x80, payload[0] = status
+ *
+ * Commands (request payload → response payload after status):
+ *
+ *   HELLO         -              → proto u8, cfg_version u8,
+ *                                  cfg_size u16, max_events u8,
+ *                                  event_size u8, version string
+ *   CONFIG_READ   -              → struct config (checksum valid)
+ *   CONFIG_WRITE  struct config  → -   (checked, applied, saved)
+ *   EVENTS_READ   -              → Event[MAX_EVENTS]
+ *   EVENTS_WRITE  Event[]        → -   (table replaced, saved)
+ *   RTC_SET       epoch u32, ms u16
+ *                                → epoch u32, compensated ms u16
+ *   STATS_READ    -              → count u8, then per counter:
+ *                                  name_len u8, name, value u32
+ *   LOG_READ      -              → count u16, dropped u16, then
+ *                                  newest first: epoch u32,
+ *                                  device u8, action u8, source u8
+ *   EXIT          -              → -   (back to text console)
+ *
+ * Notes:
+ *  - Structs travel in their AVR memory layout (packed, no
+ *    padding); HELLO reports sizes so a host can refuse a
+ *    layout it does not know
+ *  - RTC_SET epoch is Unix time (UTC seconds since 1970-01-01,
+ *    as rtc_get_epoch()) plus ms,
+ *    stamped by the host just before sending. The device adds
+ *    the time since the frame's first byte arrived and writes
+ *    the RTC on the next whole second
+ *  - Host tool: tools/coopbin.py
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Text console: STX followed by "COOP" switches to binary */
+#define BIN_MAGIC           "\x02" "COOP"
+
+#define BIN_SOF             0xA5u
+#define BIN_PROTO_VERSION   1u
+
+/* Largest request payload (CONFIG_WRITE) */
+#define BIN_RX_MAX          128u
+
+/* Gap inside a frame that aborts it */
+#define BIN_BYTE_TIMEOUT_MS 100u
+
+/* No frame for this long → back to the text console */
+#define BIN_IDLE_MS         30000u
+
+typedef enum : uint8_t {
+    BIN_CMD_HELLO        = 0x01,
+    BIN_CMD_CONFIG_READ  = 0x02,
+    BIN_CMD_CONFIG_WRITE = 0x03,
+    BIN_CMD_EVENTS_READ  = 0x04,
+    BIN_CMD_EVENTS_WRITE = 0x05,
+    BIN_CMD_RTC_SET      = 0x06,
+    BIN_CMD_STATS_READ   = 0x07,
+    BIN_CMD_LOG_READ     = 0x08,
+    BIN_CMD_EXIT         = 0x0F
+} bin_cmd_t;
+
+#define BIN_RESPONSE        0x80u
+
+typedef enum : uint8_t {
+    BIN_ST_OK = 0,
+    BIN_ST_CRC,             /* frame CRC mismatch */
+    BIN_ST_LEN,             /* payload length wrong for command */
+    BIN_ST_CMD,             /* unknown command */
+    BIN_ST_INVALID,         /* payload failed validation */
+    BIN_ST_RTC              /* RTC write failed */
+} bin_status_t;
+
+/* Switch the console to binary mode (text console calls this) */
+void console_bin_enter(void);
+
+/* Drop back to text mode (new console session) */
+void console_bin_exit(void);
+
+/* True while the binary protocol owns the console */
+bool console_bin_active(void);
+
+/*
+ * Service the binary protocol (from console_poll()).
+ *
+ * - Returns immediately if no byte is waiting
+ * - Once a frame starts, reads it to the end (bounded by
+ *   BIN_BYTE_TIMEOUT_MS per byte) so no byte is lost to a slow
+ *   main loop pass
+ *
+ * Returns false when the session ended (exit or idle timeout).
+ */
+bool console_bin_poll(void);
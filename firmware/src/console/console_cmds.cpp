@@ -36,11 +36,14 @@
  #include <stdlib.h>
  #include <ctype.h>
  #include <util/delay.h>
+ #include <avr/pgmspace.h>
 
 
 #include "console/console_io.h"
 #include "console/console.h"
 #include "console/mini_printf.h"
+#include "console/cfmt.h"
+#include "console/console_args.h"
 #include "time_dst.h"
 #include "console_time.h"
 #include "events.h"
@@ -59,6 +62,15 @@
 #include "devices/door_state_machine.h"
 #include "state_reducer.h"
 #include "system_sleep.h"
+#include "event_log.h"
+#include "energy.h"
+#include "latency.h"
+#include "irq_queue.h"
+#include "input.h"
+#include "mem.h"
+#include "metrics.h"
+#include "power.h"
+#include "macro_store.h"
 
 #define DOOR_SW_BIT     PD3
 #define RTC_INT_BIT     PD2
@@ -98,6 +110,11 @@ static inline uint8_t gpio_door_sw_is_asserted(void)
 static bool g_cfg_loaded = false;
 static bool g_cfg_dirty = false;
 
+// Batch state (console_exec_line): saves inside a batch are
+// deferred to its end, one EEPROM commit per batch
+static uint8_t g_batch_depth   = 0;
+static bool    g_save_deferred = false;
+
 
 /* Command handler forward declarations */
 static void console_help(int argc, char **argv);
@@ -112,6 +129,13 @@ static void cmd_door(int argc, char **argv);
 static void cmd_lock(int argc, char **argv);
 static void cmd_event(int argc, char **argv);
 static void cmd_sleep(int argc, char **argv);
+static void cmd_log(int argc, char **argv);
+static void cmd_energy(int argc, char **argv);
+static void cmd_latency(int argc, char **argv);
+static void cmd_mem(int argc, char **argv);
+static void cmd_stats(int argc, char **argv);
+static void cmd_power(int argc, char **argv);
+static void cmd_macro(int argc, char **argv);
 
 
 // -----------------------------------------------------------------------------
@@ -135,95 +159,37 @@ static void ensure_cfg_loaded(void)
     g_cfg_loaded = true;
 }
 
-
-/* -------------------------------------------------------------------------- */
-/* Date math                                                                  */
-/* -------------------------------------------------------------------------- */
-
-static bool is_leap_year(int y)
-{
-    if ((y % 400) == 0) return true;
-    if ((y % 100) == 0) return false;
-    return (y % 4) == 0;
-}
-
-static int days_in_month(int y, int mo)
+/* Commit the shadow to EEPROM (deferred while a batch runs) */
+static void cfg_commit(void)
 {
-    static const uint8_t dpm[12] =
-        {31,28,31,30,31,30,31,31,30,31,30,31};
+    if (g_batch_depth)
+        g_save_deferred = true;
+    else
+        config_save(&g_cfg);
 
-    if (mo < 1 || mo > 12) return 31;
-    if (mo == 2 && is_leap_year(y)) return 29;
-    return dpm[mo - 1];
+    g_cfg_dirty = false;
 }
 
-/* -------------------------------------------------------------------------- */
-/* Parsing helpers                                                            */
-/* -------------------------------------------------------------------------- */
-
-static bool parse_date_ymd(const char *s, int *y, int *mo, int *d)
+void console_batch_begin(void)
 {
-    if (!s || strlen(s) != 10) return false;
-    if (s[4] != '-' || s[7] != '-') return false;
-
-    for (int i = 0; i < 10; i++) {
-        if (i == 4 || i == 7) continue;
-        if (s[i] < '0' || s[i] > '9') return false;
-    }
-
-    *y  = atoi(s);
-    *mo = atoi(s + 5);
-    *d  = atoi(s + 8);
-
-    if (*y < 2000 || *y > 2099) return false;
-    if (*mo < 1 || *mo > 12)   return false;
-    if (*d < 1 || *d > days_in_month(*y, *mo)) return false;
-
-    return true;
+    g_batch_depth++;
 }
 
-/* HH:MM (24-hour) — used for door rules */
-static bool parse_time_hm(const char *s, int *h, int *m)
+void console_batch_end(void)
 {
-    if (!s || strlen(s) != 5) return false;
-    if (s[2] != ':') return false;
+    if (!g_batch_depth || --g_batch_depth)
+        return;
 
-    for (int i = 0; i < 5; i++) {
-        if (i == 2) continue;
-        if (s[i] < '0' || s[i] > '9') return false;
+    if (g_save_deferred) {
+        g_save_deferred = false;
+        config_save(&g_cfg);
     }
-
-    *h = atoi(s);
-    *m = atoi(s + 3);
-
-    if (*h < 0 || *h > 23) return false;
-    if (*m < 0 || *m > 59) return false;
-
-    return true;
 }
 
 
-static bool parse_time_hms(const char *s,int *h,int *m,int *sec)
-{
-    // HH:MM:SS (24-hour)
-    if (!s || strlen(s) != 8) return false;
-    if (s[2] != ':' || s[5] != ':') return false;
-    for (int i = 0; i < 8; i++) {
-        if (i == 2 || i == 5) continue;
-        if (s[i] < '0' || s[i] > '9') return false;
-    }
-    *h   = atoi(s);
-    *m   = atoi(s + 3);
-    *sec = atoi(s + 6);
-    if (*h < 0 || *h > 23) return false;
-    if (*m < 0 || *m > 59) return false;
-    if (*sec < 0 || *sec > 59) return false;
-    return true;
-}
-
 static void print_uint_padded(unsigned v, size_t width)
 {
-    mini_printf("%u", v);
+    mini_printf(FSTR("%u"), v);
 
     /* count digits */
     unsigned n = 1;
@@ -237,12 +203,12 @@ static void print_uint_padded(unsigned v, size_t width)
         console_putc(' ');
 }
 
-static void print_padded(const char *s, size_t width)
+static void print_padded(flash_str s, size_t width)
 {
     if (!s)
-        s = "?";
+        s = FS(QMARK);
 
-    size_t n = strlen(s);
+    size_t n = strlen_P(flash_ptr(s));
     console_puts(s);
 
     while (n++ < width)
@@ -253,7 +219,7 @@ static void print_padded(const char *s, size_t width)
 static void when_print(const struct When *w)
 {
     if (!w) {
-        console_puts("?");
+        console_puts(FSTR("?"));
         return;
     }
 
@@ -264,58 +230,40 @@ static void when_print(const struct When *w)
     switch (w->ref) {
 
     case REF_NONE:
-        console_puts("DISABLED");
+        console_puts(FSTR("DISABLED"));
         return;
 
     case REF_MIDNIGHT: {
         int h = off / 60;
         int m = abs(off % 60);
-        mini_printf("%02d:%02d", h, m);
+        mini_printf(FSTR("%02d:%02d"), h, m);
         return;
     }
 
     case REF_SOLAR_STD_RISE:
-        mini_printf("Sunrise %c%d", sign, mins);
+        mini_printf(FSTR("Sunrise %c%d"), sign, mins);
         return;
 
     case REF_SOLAR_STD_SET:
-        mini_printf("Sunset %c%d", sign, mins);
+        mini_printf(FSTR("Sunset %c%d"), sign, mins);
         return;
 
     case REF_SOLAR_CIV_RISE:
-        mini_printf("Dawn %c%d", sign, mins);
+        mini_printf(FSTR("Dawn %c%d"), sign, mins);
         return;
 
     case REF_SOLAR_CIV_SET:
-        mini_printf("Dusk %c%d", sign, mins);
+        mini_printf(FSTR("Dusk %c%d"), sign, mins);
         return;
 
     default:
-        console_puts("?");
+        console_puts(FSTR("?"));
         return;
     }
 }
 
 
 
-static bool parse_signed_int(const char *s, int *out)
-{
-    if (!s || !*s)
-        return false;
-
-    char *end = NULL;
-    long v = strtol(s, &end, 10);
-
-    if (*end != '\0')
-        return false;
-
-    if (v < -32768 || v > 32767)
-        return false;
-
-    *out = (int)v;
-    return true;
-}
-
 static bool compute_today_solar(struct solar_times *out)
 {
     if (!out)
@@ -354,13 +302,13 @@ static bool compute_today_solar(struct solar_times *out)
 
 static void cmd_version(int,char**)
 {
-    console_puts("Chicken Coop Controller ");
+    console_puts(FS(BANNER));
     console_puts(PROJECT_VERSION);
-    console_puts(" (");
+    console_puts(FSTR(" ("));
     console_puts(__DATE__);
-    console_puts(" ");
+    console_puts(FSTR(" "));
     console_puts(__TIME__);
-    console_puts(")\n");
+    console_puts(FSTR(")\n"));
 }
 
 static void cmd_time(int, char **)
@@ -369,7 +317,7 @@ static void cmd_time(int, char **)
 
     /* Otherwise fall back to RTC */
     if (!rtc_time_is_set()) {
-        console_puts("TIME: NOT SET\n");
+        console_puts(FS(TIME_NOT_SET));
         return;
     }
 
@@ -387,7 +335,7 @@ static void cmd_solar(int argc, char **argv)
     ensure_cfg_loaded();
 
     if (!rtc_time_is_set()) {
-        console_puts("TIME: NOT SET\n");
+        console_puts(FS(TIME_NOT_SET));
         return;
     }
 
@@ -407,21 +355,21 @@ static void cmd_solar(int argc, char **argv)
                        lon,
                        effective_tz,
                        &sol)) {
-        console_puts("SOLAR: UNAVAILABLE\n");
+        console_puts(FSTR("SOLAR: UNAVAILABLE\n"));
         return;
     }
 
-    console_puts("           Rise        Set\n");
+    console_puts(FSTR("           Rise        Set\n"));
 
-    console_puts("Actual     ");
+    console_puts(FS(SOLAR_ACTUAL));
     print_hhmm(sol.sunrise_std);
-    console_puts("    ");
+    console_puts(FS(GAP4));
     print_hhmm(sol.sunset_std);
     console_putc('\n');
 
-    console_puts("Civil      ");
+    console_puts(FS(SOLAR_CIVIL));
     print_hhmm(sol.sunrise_civ);
-    console_puts("    ");
+    console_puts(FS(GAP4));
     print_hhmm(sol.sunset_civ);
     console_putc('\n');
 }
@@ -437,53 +385,53 @@ static void cmd_schedule(int argc, char **argv)
     int y, mo, d, h, m, s;
 
     if (!rtc_time_is_set()) {
-        console_puts("TIME: NOT SET\n");
+        console_puts(FS(TIME_NOT_SET));
         return;
     }
 
     rtc_get_time(&y, &mo, &d, &h, &m, &s);
 
     /* ----- Header ----- */
-    mini_printf("Today: %04d-%02d-%02d\n\n", y, mo, d);
+    cfmt("Today: %04d-%02d-%02d\n\n", y, mo, d);
 
-    mini_printf("lat/long  : %L, %L\n",
-                g_cfg.latitude_e4,
-                g_cfg.longitude_e4);
+    cfmt("lat/long  : %L, %L\n",
+         g_cfg.latitude_e4,
+         g_cfg.longitude_e4);
 
-     mini_printf("TZ        : %d (DST ", g_cfg.tz);
-     mini_printf("%s", g_cfg.honor_dst ? "ON" : "OFF");
-     mini_printf(")\n\n");
+    cfmt("TZ        : %ld (DST %s)\n\n",
+         g_cfg.tz,
+         g_cfg.honor_dst ? FS(ON) : FS(OFF));
 
     /* ----- Solar ----- */
     struct solar_times sol;
     bool have_sol = compute_today_solar(&sol);
 
     if (have_sol) {
-        console_puts("Solar      Rise        Set\n");
-        console_puts("Actual     ");
+        console_puts(FSTR("Solar      Rise        Set\n"));
+        console_puts(FS(SOLAR_ACTUAL));
         print_hhmm(sol.sunrise_std);
-        console_puts("    ");
+        console_puts(FS(GAP4));
         print_hhmm(sol.sunset_std);
         console_putc('\n');
 
-        console_puts("Civil      ");
+        console_puts(FS(SOLAR_CIVIL));
         print_hhmm(sol.sunrise_civ);
-        console_puts("    ");
+        console_puts(FS(GAP4));
         print_hhmm(sol.sunset_civ);
         console_putc('\n');
     } else {
-        console_puts("Solar: UNAVAILABLE\n");
+        console_puts(FSTR("Solar: UNAVAILABLE\n"));
     }
 
     console_putc('\n');
-    console_puts("Events:\n");
+    console_puts(FSTR("Events:\n"));
 
     /* ----- Events ----- */
     size_t used = 0;
     const Event *events = config_events_get(&used);
 
     if (used == 0) {
-        console_puts("(no events)\n");
+        console_puts(FS(NO_EVENTS));
         return;
     }
 
@@ -510,7 +458,7 @@ static void cmd_schedule(int argc, char **argv)
     }
 
     if (rc == 0) {
-        console_puts("(no resolvable events)\n");
+        console_puts(FSTR("(no resolvable events)\n"));
         return;
     }
 
@@ -530,8 +478,8 @@ static void cmd_schedule(int argc, char **argv)
         const Event *ev = rows[i].ev;
         uint16_t min = rows[i].minute;
 
-        const char *dev = "?";
-        const char *state = "?";
+        flash_str dev   = FS(QMARK);
+        flash_str state = FS(QMARK);
 
         device_name(ev->device_id, &dev);
 
@@ -540,9 +488,9 @@ static void cmd_schedule(int argc, char **argv)
 
         device_get_state_string(ev->device_id, st, &state);
 
-        mini_printf("%02u:%02u  ",
-            (unsigned)(min / 60),
-            (unsigned)(min % 60));
+        cfmt("%02u:%02u  ",
+             (unsigned)(min / 60),
+             (unsigned)(min % 60));
 
         print_padded(dev,   8);
         print_padded(state, 8);
@@ -556,44 +504,99 @@ static void cmd_schedule(int argc, char **argv)
 // src/console/console_cmds.cpp
 // src/console/console_cmds.cpp
 
+/* --------------------------------------------------------------------------
+ * Settable config fields (set / config)
+ *
+ * name, argument spec, field, width, flags
+ * -------------------------------------------------------------------------- */
+
+#define SET_F_SOLAR   0x01u     /* invalidates solar times */
+#define SET_F_ENERGY  0x02u     /* energy model coefficient */
+
+struct set_field {
+    char            name[15];
+    struct arg_spec spec;
+    void           *field;
+    uint8_t         size;       /* bytes: 1, 2 or 4 */
+    uint8_t         flags;
+};
+
+static const char set_onoff_words[] PROGMEM = "off|on";
+
+#define SET_U16(name, lo, hi, field, flags) \
+    { name, ARG_SPEC_INT(lo, hi), &g_cfg.field, 2, flags }
+
+static const struct set_field g_set_fields[] PROGMEM = {
+    { "lat", ARG_SPEC_E4(-900000L, 900000L),
+      &g_cfg.latitude_e4,  4, SET_F_SOLAR },
+    { "lon", ARG_SPEC_E4(-1800000L, 1800000L),
+      &g_cfg.longitude_e4, 4, SET_F_SOLAR },
+    { "tz",  ARG_SPEC_INT(-12, 14),
+      &g_cfg.tz,           4, SET_F_SOLAR },
+    { "dst", ARG_SPEC_ENUM(set_onoff_words),
+      &g_cfg.honor_dst,    1, SET_F_SOLAR },
+
+    SET_U16("lock_pulse_ms",  50,   5001,  lock_pulse_ms,  0),
+    SET_U16("door_settle_ms", 50,   5001,  door_settle_ms, 0),
+    SET_U16("lock_settle_ms", 0,    2001,  lock_settle_ms, 0),
+    SET_U16("door_travel_ms", 1000, 30000, door_travel_ms, 0),
+
+    SET_U16("batt_mah",   0, 65535L, batt_capacity_mah, SET_F_ENERGY),
+    SET_U16("sleep_ua",   0, 65535L, sleep_ua,          SET_F_ENERGY),
+    SET_U16("awake_ua",   0, 65535L, awake_ua,          SET_F_ENERGY),
+    SET_U16("console_ua", 0, 65535L, console_ua,        SET_F_ENERGY),
+    SET_U16("i2c_nc",     0, 65535L, i2c_nc,            SET_F_ENERGY),
+    SET_U16("motor_ma",   0, 65535L, door_motor_ma,     SET_F_ENERGY),
+    SET_U16("lock_ma",    0, 65535L, lock_ma,           SET_F_ENERGY),
+    SET_U16("relay_ma",   0, 65535L, relay_ma,          SET_F_ENERGY),
+};
+
+#undef SET_U16
+
+#define SET_FIELD_COUNT \
+    (sizeof(g_set_fields) / sizeof(g_set_fields[0]))
+
+static const char set_date_name[] PROGMEM = "date";
+static const char set_time_name[] PROGMEM = "time";
+
+static const struct arg_spec set_date_spec PROGMEM = ARG_SPEC_DATE;
+static const struct arg_spec set_time_spec PROGMEM = ARG_SPEC_TIME;
+
 static void cmd_set(int argc, char **argv)
 {
     ensure_cfg_loaded();
 
-    if (argc < 3) {
-        console_puts("?\n");
+    if (argc != 3) {
+        console_puts(FS(WHAT));
         return;
     }
 
+    int32_t v;
+
     /* --------------------------------------------------
      * set date YYYY-MM-DD
      * Commits immediately to RTC using existing RTC time
      * -------------------------------------------------- */
-    if (!strcmp(argv[1], "date") && argc == 3) {
+    if (!strcmp_P(argv[1], set_date_name)) {
         int yy, mm, dd;
         int h, m, s;
 
-        if (!parse_date_ymd(argv[2], &yy, &mm, &dd)) {
-            console_puts("ERROR\n");
+        if (!arg_parse(&set_date_spec, argv[2], &v)) {
+            console_puts(FS(ERROR));
             return;
         }
-
-        // /* RTC must already have a valid time */
-        // if (!rtc_time_is_set()) {
-        //     console_puts("ERROR: RTC TIME NOT SET\n");
-        //     return;
-        // }
+        arg_date(v, &yy, &mm, &dd);
 
         /* Preserve existing RTC time-of-day */
         rtc_get_time(NULL, NULL, NULL, &h, &m, &s);
 
         if (!rtc_set_time(yy, mm, dd, h, m, s)) {
-            console_puts("ERROR: RTC SET FAILED\n");
+            console_puts(FS(RTC_SET_FAILED));
             return;
         }
 
         scheduler_invalidate_solar();
-        console_puts("OK\n");
+        console_puts(FS(OK));
         return;
     }
 
@@ -602,22 +605,19 @@ static void cmd_set(int argc, char **argv)
      * Commits immediately to RTC using existing RTC date
      * Also records epoch at time of set (UTC-normalized)
      * -------------------------------------------------- */
-    if (!strcmp(argv[1], "time") && argc == 3) {
+    if (!strcmp_P(argv[1], set_time_name)) {
 
-        int hh = 0, mi = 0, ss = 0;
+        int hh, mi, ss;
         int y, mo, d;
 
-        if (parse_time_hms(argv[2], &hh, &mi, &ss)) {
-            /* HH:MM:SS */
-        } else if (parse_time_hm(argv[2], &hh, &mi)) {
-            ss = 0;
-        } else {
-            console_puts("ERROR\n");
+        if (!arg_parse(&set_time_spec, argv[2], &v)) {
+            console_puts(FS(ERROR));
             return;
         }
+        arg_time(v, &hh, &mi, &ss);
 
         if (!rtc_time_is_set()) {
-            console_puts("ERROR: RTC DATE NOT SET\n");
+            console_puts(FSTR("ERROR: RTC DATE NOT SET\n"));
             return;
         }
 
@@ -626,7 +626,7 @@ static void cmd_set(int argc, char **argv)
 
         /* Program RTC */
         if (!rtc_set_time(y, mo, d, hh, mi, ss)) {
-            console_puts("ERROR: RTC SET FAILED\n");
+            console_puts(FS(RTC_SET_FAILED));
             return;
         }
 
@@ -639,138 +639,45 @@ static void cmd_set(int argc, char **argv)
                 g_cfg.honor_dst
             );
 
-        /* Immediately persist drift baseline */
-        config_save(&g_cfg);
-
-        g_cfg_dirty = false;
-
-        console_puts("OK\n");
-        return;
-    }
-
-    /* --------------------------------------------------
-     * set lat +/-DD.DDDD
-     * -------------------------------------------------- */
-    if (!strcmp(argv[1], "lat") && argc == 3) {
-        float v = atof(argv[2]);
-        if (v < -90.0f || v > 90.0f) {
-            console_puts("ERROR\n");
-            return;
-        }
+        /* Persist drift baseline (end of batch at the latest) */
+        cfg_commit();
 
-        g_cfg.latitude_e4 = (int32_t)(v * 10000.0f);
-        g_cfg_dirty = true;
-        scheduler_invalidate_solar();
-        console_puts("OK\n");
+        console_puts(FS(OK));
         return;
     }
 
     /* --------------------------------------------------
-     * set lon +/-DDD.DDDD
+     * set <field> <value>: location, timing, energy model
      * -------------------------------------------------- */
-    if (!strcmp(argv[1], "lon") && argc == 3) {
-        float v = atof(argv[2]);
-        if (v < -180.0f || v > 180.0f) {
-            console_puts("ERROR\n");
-            return;
-        }
+    for (size_t i = 0; i < SET_FIELD_COUNT; i++) {
 
-        g_cfg.longitude_e4 = (int32_t)(v * 10000.0f);
-        g_cfg_dirty = true;
-        scheduler_invalidate_solar();
-        console_puts("OK\n");
-        return;
-    }
+        const struct set_field *f = &g_set_fields[i];
 
-    /* --------------------------------------------------
-     * set tz +/-HH
-     * -------------------------------------------------- */
-    if (!strcmp(argv[1], "tz") && argc == 3) {
-        int v = atoi(argv[2]);
-        if (v < -12 || v > 14) {
-            console_puts("ERROR\n");
-            return;
-        }
-
-        g_cfg.tz = v;
-        g_cfg_dirty = true;
-        scheduler_invalidate_solar();
-        console_puts("OK\n");
-        return;
-    }
+        if (strcmp_P(argv[1], f->name))
+            continue;
 
-    /* --------------------------------------------------
-     * set dst on|off
-     * -------------------------------------------------- */
-    if (!strcmp(argv[1], "dst") && argc == 3) {
-        if (!strcmp(argv[2], "on"))
-            g_cfg.honor_dst = true;
-        else if (!strcmp(argv[2], "off"))
-            g_cfg.honor_dst = false;
-        else {
-            console_puts("ERROR\n");
+        if (!arg_parse(&f->spec, argv[2], &v)) {
+            console_puts(FS(ERROR));
             return;
         }
 
-        g_cfg_dirty = true;
-        scheduler_invalidate_solar();
-        console_puts("OK\n");
-        return;
-    }
-
-    /* --------------------------------------------------
-     * Mechanical timing parameters (unchanged)
-     * -------------------------------------------------- */
+        void *field = pgm_read_ptr(&f->field);
 
-    if (!strcmp(argv[1], "lock_pulse_ms") && argc == 3) {
-        int v = atoi(argv[2]);
-        if (v < 50 || v > 5001) {
-            console_puts("ERROR\n");
-            return;
+        switch (pgm_read_byte(&f->size)) {
+        case 1:  *(uint8_t  *)field = (uint8_t)v;  break;
+        case 2:  *(uint16_t *)field = (uint16_t)v; break;
+        default: *(int32_t  *)field = v;           break;
         }
-        g_cfg.lock_pulse_ms = (uint16_t)v;
-        g_cfg_dirty = true;
-        console_puts("OK\n");
-        return;
-    }
 
-    if (!strcmp(argv[1], "door_settle_ms") && argc == 3) {
-        int v = atoi(argv[2]);
-        if (v < 50 || v > 5001) {
-            console_puts("ERROR\n");
-            return;
-        }
-        g_cfg.door_settle_ms = (uint16_t)v;
-        g_cfg_dirty = true;
-        console_puts("OK\n");
-        return;
-    }
+        if (pgm_read_byte(&f->flags) & SET_F_SOLAR)
+            scheduler_invalidate_solar();
 
-    if (!strcmp(argv[1], "lock_settle_ms") && argc == 3) {
-        int v = atoi(argv[2]);
-        if (v > 2001) {
-            console_puts("ERROR\n");
-            return;
-        }
-        g_cfg.lock_settle_ms = (uint16_t)v;
-        g_cfg_dirty = true;
-        console_puts("OK\n");
-        return;
-    }
-
-    if (!strcmp(argv[1], "door_travel_ms") && argc == 3) {
-        int v = atoi(argv[2]);
-        if (v < 1000 || v > 30000) {
-            console_puts("ERROR\n");
-            return;
-        }
-        g_cfg.door_travel_ms = (uint16_t)v;
         g_cfg_dirty = true;
-        console_puts("OK\n");
+        console_puts(FS(OK));
         return;
     }
 
-    console_puts("?\n");
+    console_puts(FS(WHAT));
 }
 
  static void cmd_device(int argc, char **argv)
@@ -784,8 +691,8 @@ static void cmd_set(int argc, char **argv)
                 ok = device_enum_next(id, &id)) {
 
                 dev_state_t st;
-                const char *name;
-                const char *str;
+                flash_str name;
+                flash_str str;
 
                 if(id == DEVICE_ID_LED)
                     continue;
@@ -800,7 +707,7 @@ static void cmd_set(int argc, char **argv)
                     continue;
 
                 console_puts(name);
-                console_puts(": ");
+                console_puts(FSTR(": "));
                 console_puts(str);
                 console_putc('\n');
             }
@@ -814,26 +721,33 @@ static void cmd_set(int argc, char **argv)
 
          /* NOTE: 0 == fail */
          if (!device_lookup_id(argv[1], &id)) {
-             console_puts("ERROR\n");
+             console_puts(FS(ERROR));
              return;
          }
 
          dev_state_t want;
          if (!device_parse_state_by_id(id, argv[2], &want)) {
-             console_puts("ERROR\n");
+             console_puts(FS(ERROR));
              return;
          }
 
          if (!device_set_state_by_id(id,want)) {
-             console_puts("ERROR\n");
+             console_puts(FS(ERROR));
              return;
          }
 
-         console_puts("OK\n");
+         if (want == DEV_STATE_ON || want == DEV_STATE_OFF) {
+             event_log_append(id,
+                              (want == DEV_STATE_ON) ? EVLOG_ACTION_ON
+                                                     : EVLOG_ACTION_OFF,
+                              EVLOG_SRC_CONSOLE);
+         }
+
+         console_puts(FS(OK));
          return;
      }
 
-     console_puts("?\n");
+     console_puts(FS(WHAT));
  }
 
 
@@ -844,39 +758,50 @@ static void cmd_set(int argc, char **argv)
 
      ensure_cfg_loaded();
 
-     config_save(&g_cfg);
+     cfg_commit();
 
-     g_cfg_dirty = false;
-     console_puts("OK\n");
+     console_puts(FS(OK));
  }
 
  static void cmd_door(int argc, char **argv)
  {
      if (argc != 2) {
-         console_puts("usage: door open|close|toggle|status\n");
+         console_puts(FSTR("usage: door open|close|toggle|status\n"));
          return;
      }
 
-     if (!strcmp(argv[1], "open")) {
+     if (!strcmp_P(argv[1], PSTR("open"))) {
          door_sm_request(DEV_STATE_ON);
+         event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_ON, EVLOG_SRC_CONSOLE);
      }
-     else if (!strcmp(argv[1], "close")) {
+     else if (!strcmp_P(argv[1], PSTR("close"))) {
          door_sm_request(DEV_STATE_OFF);
+         event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_OFF, EVLOG_SRC_CONSOLE);
      }
-     else if (!strcmp(argv[1], "toggle")) {
+     else if (!strcmp_P(argv[1], PSTR("toggle"))) {
          door_sm_toggle();
+         if (door_sm_get_motion() == DOOR_MOVING_OPEN)
+             event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_ON, EVLOG_SRC_CONSOLE);
+         else if (door_sm_get_motion() == DOOR_MOVING_CLOSE)
+             event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_OFF, EVLOG_SRC_CONSOLE);
      }
-     else if (!strcmp(argv[1], "status")) {
+     else if (!strcmp_P(argv[1], PSTR("status"))) {
          /* no action */
      }
      else {
-         console_puts("?\n");
+         console_puts(FS(WHAT));
          return;
      }
 
-     mini_printf("door: %s  motion=%s\n",
+     mini_printf(FSTR("door: %S  motion=%S\n"),
                  door_sm_state_string(),
                  door_sm_motion_string());
+
+     uint16_t pos;
+     if (door_sm_get_position(&pos))
+         mini_printf(FSTR("position: %u / %u ms\n"), pos, g_cfg.door_travel_ms);
+     else
+         console_puts(FSTR("position: unknown\n"));
  }
 
 
@@ -885,50 +810,57 @@ static void cmd_set(int argc, char **argv)
 
 static void cmd_lock(int argc, char **argv)
 {
-    if (argc != 2) {
-        console_puts("usage: lock engage|release\n");
+    if (argc == 1) {
+        door_lock_state_t st = door_lock_get_state();
+
+        mini_printf(FSTR("lock: %S\n"),
+                    (st == LOCK_STATE_LOCKED)   ? FSTR("locked")   :
+                    (st == LOCK_STATE_UNLOCKED) ? FSTR("unlocked") : FSTR("unknown"));
         return;
     }
 
-    if (!strcmp(argv[1], "engage")) {
-        console_puts("Locking...\n");
-        door_lock_engage();     /* blocking, safe */
-        console_puts("Lock engaged\n");
+    /* Manual override: always pulse, whatever the believed state */
+    if (!strcmp_P(argv[1], PSTR("engage"))) {
+        console_puts(FSTR("Locking...\n"));
+        door_lock_engage_force();   /* blocking, safe */
+        event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_LOCK, EVLOG_SRC_CONSOLE);
+        console_puts(FSTR("Lock engaged\n"));
         return;
     }
 
-    if (!strcmp(argv[1], "release")) {
-        console_puts("Unlocking...\n");
-        door_lock_release();    /* blocking, safe */
-        console_puts("Lock released\n");
+    if (!strcmp_P(argv[1], PSTR("release"))) {
+        console_puts(FSTR("Unlocking...\n"));
+        door_lock_release_force();  /* blocking, safe */
+        event_log_append(DEVICE_ID_DOOR, EVLOG_ACTION_UNLOCK, EVLOG_SRC_CONSOLE);
+        console_puts(FSTR("Lock released\n"));
         return;
     }
 
-    console_puts("usage: lock engage|release\n");
+    console_puts(FSTR("usage: lock [engage|release]\n"));
 }
 
 static void cmd_led(int argc, char **argv)
 {
     if (argc != 2) {
-        console_puts("usage: led off|red|green|pulse_red|pulse_green|blink_red|blink_green\n");
+        console_puts(FSTR("usage: led off|red|green|pulse_red|pulse_green|blink_red|blink_green\n"));
         return;
     }
 
     const char *s = argv[1];
 
-    if (!strcmp(s, "off"))               led_state_machine_set(LED_OFF,LED_RED );
-    else if (!strcmp(s, "red"))         led_state_machine_set(LED_ON, LED_RED);
-    else if (!strcmp(s, "green"))       led_state_machine_set(LED_ON, LED_GREEN);
-    else if (!strcmp(s, "pulse_red"))   led_state_machine_set(LED_PULSE, LED_RED);
-    else if (!strcmp(s, "pulse_green")) led_state_machine_set(LED_PULSE, LED_GREEN);
-    else if (!strcmp(s, "blink_red"))   led_state_machine_set(LED_BLINK, LED_RED);
-    else if (!strcmp(s, "blink_green")) led_state_machine_set(LED_BLINK, LED_GREEN);
+    if (!strcmp_P(s, PSTR("off")))               led_state_machine_set(LED_OFF,LED_RED );
+    else if (!strcmp_P(s, PSTR("red")))         led_state_machine_set(LED_ON, LED_RED);
+    else if (!strcmp_P(s, PSTR("green")))       led_state_machine_set(LED_ON, LED_GREEN);
+    else if (!strcmp_P(s, PSTR("pulse_red")))   led_state_machine_set(LED_PULSE, LED_RED);
+    else if (!strcmp_P(s, PSTR("pulse_green"))) led_state_machine_set(LED_PULSE, LED_GREEN);
+    else if (!strcmp_P(s, PSTR("blink_red")))   led_state_machine_set(LED_BLINK, LED_RED);
+    else if (!strcmp_P(s, PSTR("blink_green"))) led_state_machine_set(LED_BLINK, LED_GREEN);
     else {
-        console_puts("ERROR\n");
+        console_puts(FS(ERROR));
         return;
     }
 
-    console_puts("OK\n");
+    console_puts(FS(OK));
 }
 
 
@@ -937,8 +869,14 @@ static void cmd_rtc(int argc, char **argv)
     (void)argc;
     (void)argv;
 
+    static const char osc_names[][11] PROGMEM = {
+        "unverified", "verified", "STALLED"
+    };
+
+    mini_printf(FSTR("oscillator: %S\n"), FSTR_ARR(osc_names[rtc_osc_state()]));
+
     if (!rtc_time_is_set()) {
-        console_puts("RTC: INVALID (oscillator stopped or time not set)\n");
+        console_puts(FSTR("RTC: INVALID (oscillator stopped or time not set)\n"));
         return;
     }
 
@@ -946,19 +884,19 @@ static void cmd_rtc(int argc, char **argv)
     rtc_get_time(&y, &mo, &d, &h, &m, &s);
     uint32_t epoch = rtc_get_epoch();
 
-    console_puts("RTC: VALID\n");
-    mini_printf("date: %04d-%02d-%02d\n", y, mo, d);
-    mini_printf("time: %02d:%02d:%02d\n", h, m, s);
-    mini_printf("epoch: %lu\n", (unsigned long)epoch);
+    console_puts(FSTR("RTC: VALID\n"));
+    mini_printf(FSTR("date: %04d-%02d-%02d\n"), y, mo, d);
+    mini_printf(FSTR("time: %02d:%02d:%02d\n"), h, m, s);
+    mini_printf(FSTR("epoch: %lu\n"), (unsigned long)epoch);
 
     uint16_t mins = rtc_minutes_since_midnight();
-    mini_printf("minutes_since_midnight: %u\n", (unsigned)mins);
+    mini_printf(FSTR("minutes_since_midnight: %u\n"), (unsigned)mins);
 
     /* --------------------------------------------------
         * Drift measurement
         * -------------------------------------------------- */
        if (g_cfg.rtc_set_epoch == 0) {
-           console_puts("since_set: UNKNOWN\n");
+           console_puts(FSTR("since_set: UNKNOWN\n"));
            return;
        }
 
@@ -981,7 +919,7 @@ static void cmd_rtc(int argc, char **argv)
        uint32_t secs  = delta % 60u;
 
        mini_printf(
-           "since_set: %lu sec (%lu days %02lu:%02lu:%02lu)\n",
+           FSTR("since_set: %lu sec (%lu days %02lu:%02lu:%02lu)\n"),
            (unsigned long)(epoch - g_cfg.rtc_set_epoch),
            (unsigned long)days,
            (unsigned long)hours,
@@ -996,32 +934,42 @@ static void cmd_config(int, char **)
     ensure_cfg_loaded();
 
     if (g_cfg_dirty)
-        console_puts("CONFIG (UNSAVED)\n\n");
+        console_puts(FSTR("CONFIG (UNSAVED)\n\n"));
     else
-        console_puts("CONFIG (SAVED)\n\n");
+        console_puts(FSTR("CONFIG (SAVED)\n\n"));
 
     /* lat / lon / tz */
-    mini_printf("lat  : %L\n", g_cfg.latitude_e4);
-    mini_printf("lon  : %L\n", g_cfg.longitude_e4);
-    mini_printf("tz   : %d\n",   g_cfg.tz);
+    cfmt("lat  : %L\n", g_cfg.latitude_e4);
+    cfmt("lon  : %L\n", g_cfg.longitude_e4);
+    cfmt("tz   : %ld\n", g_cfg.tz);
 
-    mini_printf("dst  : %s\n",
-                g_cfg.honor_dst ? "ON (US rules)" : "OFF");
+    cfmt("dst  : %s\n",
+         g_cfg.honor_dst ? FSTR("ON (US rules)") : FS(OFF));
 
     /* drift baseline */
     if (g_cfg.rtc_set_epoch != 0) {
-        mini_printf("rtc_set_epoch : %lu\n",
-                    (unsigned long)g_cfg.rtc_set_epoch);
+        cfmt("rtc_set_epoch : %lu\n", g_cfg.rtc_set_epoch);
     } else {
-        console_puts("rtc_set_epoch : (not set)\n");
+        console_puts(FSTR("rtc_set_epoch : (not set)\n"));
     }
 
 
     /* mechanical timing */
-     mini_printf("door_travel_ms : %u\n", g_cfg.door_travel_ms);
-     mini_printf("door_settle_ms : %u\n", g_cfg.door_settle_ms);
-     mini_printf("lock_pulse_ms  : %u\n", g_cfg.lock_pulse_ms);
-     mini_printf("lock_settle_ms : %u\n", g_cfg.lock_settle_ms);
+    cfmt("door_travel_ms : %u\n", g_cfg.door_travel_ms);
+    cfmt("door_settle_ms : %u\n", g_cfg.door_settle_ms);
+    cfmt("lock_pulse_ms  : %u\n", g_cfg.lock_pulse_ms);
+    cfmt("lock_settle_ms : %u\n", g_cfg.lock_settle_ms);
+
+    /* energy model */
+    for (size_t i = 0; i < SET_FIELD_COUNT; i++) {
+        const struct set_field *f = &g_set_fields[i];
+
+        if (!(pgm_read_byte(&f->flags) & SET_F_ENERGY))
+            continue;
+
+        print_padded(FSTR_ARR(f->name), 15);
+        cfmt(": %u\n", *(const uint16_t *)pgm_read_ptr(&f->field));
+    }
 
     console_putc('\n');
 }
@@ -1043,13 +991,13 @@ static void cmd_event(int argc, char **argv)
     /* --------------------------------------------------------------------
      * event list
      * ------------------------------------------------------------------ */
-    if (!strcmp(argv[1], "list") && argc == 2) {
+    if (!strcmp_P(argv[1], PSTR("list")) && argc == 2) {
 
         size_t count = 0;
         const Event *events = config_events_get(&count);
 
         if (count == 0) {
-            console_puts("(no events)\n");
+            console_puts(FS(NO_EVENTS));
             return;
         }
 
@@ -1093,7 +1041,7 @@ static void cmd_event(int argc, char **argv)
         }
 
         if (rcount == 0) {
-            console_puts("(no events)\n");
+            console_puts(FS(NO_EVENTS));
             return;
         }
 
@@ -1116,8 +1064,8 @@ static void cmd_event(int argc, char **argv)
             const Event *ev = r[i].ev;
             uint16_t minute = r[i].minute;
 
-            const char *dev_name = "?";
-            const char *state    = "?";
+            flash_str dev_name = FS(QMARK);
+            flash_str state    = FS(QMARK);
 
             device_name(ev->device_id, &dev_name);
 
@@ -1127,12 +1075,12 @@ static void cmd_event(int argc, char **argv)
             device_get_state_string(ev->device_id, st, &state);
 
             /* Time and stable refnum */
-            mini_printf("%02u:%02u  #",
+            mini_printf(FSTR("%02u:%02u  #"),
                         (unsigned)(minute / 60),
                         (unsigned)(minute % 60));
 
             print_uint_padded(ev->refnum, 3);
-            console_puts("  ");
+            console_puts(FSTR("  "));
 
             print_padded(dev_name, 8);
             console_putc(' ');
@@ -1149,46 +1097,46 @@ static void cmd_event(int argc, char **argv)
     /* --------------------------------------------------------------------
      * event clear
      * ------------------------------------------------------------------ */
-    if (!strcmp(argv[1], "clear") && argc == 2) {
+    if (!strcmp_P(argv[1], PSTR("clear")) && argc == 2) {
         config_events_clear();
         g_cfg_dirty = true;
-        console_puts("OK (events cleared, not saved)\n");
+        console_puts(FSTR("OK (events cleared, not saved)\n"));
         return;
     }
 
     /* --------------------------------------------------------------------
      * event delete <refnum>
      * ------------------------------------------------------------------ */
-    if (!strcmp(argv[1], "delete") && argc == 3) {
+    if (!strcmp_P(argv[1], PSTR("delete")) && argc == 3) {
 
-        char *end = NULL;
-        long ref = strtol(argv[2], &end, 10);
+        static const struct arg_spec ref_spec PROGMEM = ARG_SPEC_INT(1, 255);
+        int32_t ref;
 
-        if (!end || *end != '\0' || ref <= 0 || ref > 255) {
-            console_puts("ERROR\n");
+        if (!arg_parse(&ref_spec, argv[2], &ref)) {
+            console_puts(FS(ERROR));
             return;
         }
 
         if (!config_events_delete_by_refnum((refnum_t)ref)) {
-            console_puts("ERROR\n");
+            console_puts(FS(ERROR));
             return;
         }
 
         g_cfg_dirty = true;
-        console_puts("OK (event deleted, not saved)\n");
+        console_puts(FSTR("OK (event deleted, not saved)\n"));
         return;
     }
 
     /* --------------------------------------------------------------------
       * event add ...
       * ------------------------------------------------------------------ */
-     if (!strcmp(argv[1], "add")) {
+     if (!strcmp_P(argv[1], PSTR("add"))) {
 
          Event ev;
          memset(&ev, 0, sizeof(ev));
 
          if (argc < 5) {
-             console_puts("ERROR ARGS\n");
+             console_puts(FSTR("ERROR ARGS\n"));
              return;
          }
 
@@ -1196,7 +1144,7 @@ static void cmd_event(int argc, char **argv)
           * Device
           * -------------------------------------------------- */
          if (!device_lookup_id(argv[2], &ev.device_id)) {
-             console_puts("ERROR DEVICE\n");
+             console_puts(FSTR("ERROR DEVICE\n"));
              return;
          }
 
@@ -1205,7 +1153,7 @@ static void cmd_event(int argc, char **argv)
           * -------------------------------------------------- */
          dev_state_t st;
          if (!device_parse_state_by_id(ev.device_id, argv[3], &st)) {
-             console_puts("ERROR STATE\n");
+             console_puts(FS(ERROR_STATE));
              return;
          }
 
@@ -1214,84 +1162,73 @@ static void cmd_event(int argc, char **argv)
          else if (st == DEV_STATE_OFF)
              ev.action = ACTION_OFF;
          else {
-             console_puts("ERROR STATE\n");
+             console_puts(FS(ERROR_STATE));
              return;
          }
 
          /* --------------------------------------------------
           * WHEN parsing
+          *   HH:MM
+          *   midnight HH:MM
+          *   sunrise|sunset|dawn|dusk [+/-MIN]
           * -------------------------------------------------- */
 
-         /* implicit HH:MM */
-         if (argc == 5) {
-             int hh, mm;
-             if (parse_time_hm(argv[4], &hh, &mm)) {
-                 ev.when.ref = REF_MIDNIGHT;
-                 ev.when.offset_minutes = (int16_t)(hh * 60 + mm);
-                 goto add_event;
-             }
-         }
+         /* Word order follows enum TimeRef from REF_MIDNIGHT */
+         static const char when_words[] PROGMEM =
+             "midnight|sunrise|sunset|dawn|dusk";
 
-         /* explicit midnight HH:MM */
-         if (argc == 6 && !strcmp(argv[4], "midnight")) {
-             int hh, mm;
-             if (!parse_time_hm(argv[5], &hh, &mm)) {
-                 console_puts("ERROR TIME\n");
-                 return;
-             }
+         static const struct arg_spec when_spec[] PROGMEM = {
+             ARG_SPEC_ENUM(when_words),
+             ARG_SPEC_HHMM,
+             ARG_SPEC_INT(-1439, 1439),
+         };
+
+         int32_t v;
+
+         /* implicit HH:MM */
+         if (argc == 5 && arg_parse(&when_spec[1], argv[4], &v)) {
              ev.when.ref = REF_MIDNIGHT;
-             ev.when.offset_minutes = (int16_t)(hh * 60 + mm);
+             ev.when.offset_minutes = (int16_t)v;
              goto add_event;
          }
 
-         /* solar / civil anchors */
-         static const struct {
-             const char *name;
-             decltype(ev.when.ref) ref;
-         } when_keywords[] = {
-             { "sunrise", REF_SOLAR_STD_RISE },
-             { "sunset",  REF_SOLAR_STD_SET  },
-             { "dawn",    REF_SOLAR_CIV_RISE },
-             { "dusk",    REF_SOLAR_CIV_SET  },
-         };
-
-         for (size_t i = 0; i < sizeof(when_keywords)/sizeof(when_keywords[0]); i++) {
-             if (!strcmp(argv[4], when_keywords[i].name)) {
-
-                 ev.when.ref = when_keywords[i].ref;
-                 ev.when.offset_minutes = 0;
+         if (!arg_parse(&when_spec[0], argv[4], &v)) {
+             console_puts(FSTR("ERROR FORMAT\n"));
+             return;
+         }
 
-                 /* optional offset */
-                 if (argc == 6) {
-                     int off;
-                     if (!parse_signed_int(argv[5], &off)) {
-                         console_puts("ERROR OFFSET\n");
-                         return;
-                     }
-                     ev.when.offset_minutes = (int16_t)off;
-                 }
+         ev.when.ref = (enum TimeRef)(REF_MIDNIGHT + v);
+         ev.when.offset_minutes = 0;
 
-                 goto add_event;
+         if (ev.when.ref == REF_MIDNIGHT) {
+             if (argc != 6 || !arg_parse(&when_spec[1], argv[5], &v)) {
+                 console_puts(FSTR("ERROR TIME\n"));
+                 return;
+             }
+             ev.when.offset_minutes = (int16_t)v;
+         } else if (argc == 6) {
+             /* optional offset */
+             if (!arg_parse(&when_spec[2], argv[5], &v)) {
+                 console_puts(FSTR("ERROR OFFSET\n"));
+                 return;
              }
+             ev.when.offset_minutes = (int16_t)v;
          }
 
-         console_puts("ERROR FORMAT\n");
-         return;
-
      add_event:
          ev.refnum = 0;
 
          if (!config_events_add(&ev)) {
-             console_puts("ERROR\n");
+             console_puts(FS(ERROR));
              return;
          }
 
          g_cfg_dirty = true;
-         console_puts("OK (event added, not saved)\n");
+         console_puts(FSTR("OK (event added, not saved)\n"));
          return;
      }
 
-    console_puts("?\n");
+    console_puts(FS(WHAT));
 }
 
 
@@ -1301,12 +1238,12 @@ static void cmd_sleep(int argc, char **argv)
     ensure_cfg_loaded();
 
     if (argc < 2) {
-        console_puts("usage: sleep <minutes|next>\n");
+        console_puts(FSTR("usage: sleep <minutes|next>\n"));
         return;
     }
 
     if (!rtc_time_is_set()) {
-        console_puts("sleep: RTC not set\n");
+        console_puts(FSTR("sleep: RTC not set\n"));
         return;
     }
 
@@ -1315,13 +1252,13 @@ static void cmd_sleep(int argc, char **argv)
     /* ==========================================================
      * sleep next
      * ========================================================== */
-    if (!strcmp(argv[1], "next")) {
+    if (!strcmp_P(argv[1], PSTR("next"))) {
 
         uint16_t now_min = rtc_minutes_since_midnight();
 
         uint16_t next_min;
         if (!scheduler_next_event_minute(&next_min)) {
-            console_puts("sleep: no scheduled events\n");
+            console_puts(FSTR("sleep: no scheduled events\n"));
             return;
         }
 
@@ -1330,7 +1267,7 @@ static void cmd_sleep(int argc, char **argv)
 
         target = next_min;
 
-        mini_printf("sleep: until %02u:%02u\n",
+        mini_printf(FSTR("sleep: until %02u:%02u\n"),
                     (unsigned)(target / 60u),
                     (unsigned)(target % 60u));
     }
@@ -1340,9 +1277,11 @@ static void cmd_sleep(int argc, char **argv)
          * sleep <minutes>
          * ========================================================== */
 
-        int minutes = atoi(argv[1]);
-        if (minutes <= 0 || minutes > 1440) {
-            console_puts("sleep: invalid minutes\n");
+        static const struct arg_spec min_spec PROGMEM = ARG_SPEC_INT(1, 1440);
+        int32_t minutes;
+
+        if (!arg_parse(&min_spec, argv[1], &minutes)) {
+            console_puts(FSTR("sleep: invalid minutes\n"));
             return;
         }
 
@@ -1363,11 +1302,11 @@ static void cmd_sleep(int argc, char **argv)
         if (target <= now_min)
             target = (uint16_t)((now_min + 1u) % 1440u);
 
-        mini_printf("sleep: %u minute(s)\n", (unsigned)minutes);
-        mini_printf("now    : %02u:%02u\n",
+        mini_printf(FSTR("sleep: %u minute(s)\n"), (unsigned)minutes);
+        mini_printf(FSTR("now    : %02u:%02u\n"),
                     (unsigned)(now_min / 60u),
                     (unsigned)(now_min % 60u));
-        mini_printf("target : %02u:%02u\n",
+        mini_printf(FSTR("target : %02u:%02u\n"),
                     (unsigned)(target / 60u),
                     (unsigned)(target % 60u));
     }
@@ -1380,7 +1319,7 @@ static void cmd_sleep(int argc, char **argv)
     rtc_alarm_clear_flag();
 
     if (!rtc_alarm_set_minute_of_day(target)) {
-        console_puts("sleep: alarm set failed\n");
+        console_puts(FSTR("sleep: alarm set failed\n"));
         return;
     }
 
@@ -1394,13 +1333,21 @@ static void cmd_sleep(int argc, char **argv)
      * WAKE ANALYSIS
      * ---------------------------------------------------------- */
 
-    bool woke_rtc  = gpio_rtc_int_is_asserted();
-    bool woke_door = gpio_door_sw_is_asserted();
+    /* Wake cause: the first event queued by the sleep's ISR, or
+       the pins if it returned early on a line already low */
+    struct irq_event ev;
+    bool have_wake = irq_queue_peek(&ev);
 
-    /* If RTC woke us, clear AF */
-    if (woke_rtc) {
-        rtc_alarm_clear_flag();
-    }
+    bool woke_rtc  = have_wake ? (ev.type == IRQ_EV_RTC_ALARM)
+                               : gpio_rtc_int_is_asserted();
+    bool woke_door = have_wake ? (ev.type == IRQ_EV_BUTTON)
+                               : gpio_door_sw_is_asserted();
+
+    /* Those events are this command's: don't leave them to the
+       main loop (the button would act on the door) */
+    while (irq_queue_peek(&ev) &&
+           (ev.type == IRQ_EV_RTC_ALARM || ev.type == IRQ_EV_BUTTON))
+        (void)irq_queue_pop(&ev);
 
     /* If door woke us, wait for release (bounded) */
     if (woke_door) {
@@ -1411,15 +1358,8 @@ static void cmd_sleep(int argc, char **argv)
         }
     }
 
-    /* Clear interrupt flags */
-    EIFR |= (1u << INTF0) | (1u << INTF1);
-
-    /* Re-arm interrupts only if lines are HIGH */
-    if (!gpio_rtc_int_is_asserted())
-        EIMSK |= (1u << INT0);
-
-    if (!gpio_door_sw_is_asserted())
-        EIMSK |= (1u << INT1);
+    rtc_alarm_int_rearm();
+    input_hw_arm(INPUT_DOOR_SW);
 
     /* Visual feedback */
     if (woke_door)
@@ -1427,12 +1367,449 @@ static void cmd_sleep(int argc, char **argv)
     else if (woke_rtc)
         led_state_machine_set(LED_BLINK, LED_GREEN, 3);
 
-    mini_printf("woke: rtc=%u door=%u\n",
+    mini_printf(FSTR("woke: rtc=%u door=%u\n"),
                 woke_rtc ? 1u : 0u,
                 woke_door ? 1u : 0u);
 }
 
 
+static void log_print_rec(const struct event_log_rec *r)
+{
+    if (r->epoch == 0) {
+        console_puts(FSTR("(time not set)       "));
+    } else {
+        int y, mo, d, h, m, s;
+        rtc_ymdhms_from_epoch(r->epoch, g_cfg.tz, g_cfg.honor_dst,
+                              &y, &mo, &d, &h, &m, &s);
+        mini_printf(FSTR("%04d-%02d-%02d %02d:%02d:%02d  "), y, mo, d, h, m, s);
+    }
+
+    flash_str dev = FS(QMARK);
+    device_name(r->device_id, &dev);
+    print_padded(dev, 8);
+
+    flash_str act = FS(QMARK);
+    switch (r->action) {
+    case EVLOG_ACTION_ON:
+        device_get_state_string(r->device_id, DEV_STATE_ON, &act);
+        break;
+    case EVLOG_ACTION_OFF:
+        device_get_state_string(r->device_id, DEV_STATE_OFF, &act);
+        break;
+    case EVLOG_ACTION_LOCK:
+        act = FSTR("LOCK");
+        break;
+    case EVLOG_ACTION_UNLOCK:
+        act = FSTR("UNLOCK");
+        break;
+    default:
+        break;
+    }
+    print_padded(act, 8);
+
+    switch (r->source) {
+    case EVLOG_SRC_SCHEDULE: console_puts(FSTR("schedule")); break;
+    case EVLOG_SRC_BUTTON:   console_puts(FSTR("button"));   break;
+    case EVLOG_SRC_CONSOLE:  console_puts(FSTR("console"));  break;
+    default:                 console_puts(FSTR("?"));        break;
+    }
+
+    console_putc('\n');
+}
+
+static void cmd_log(int argc, char **argv)
+{
+    ensure_cfg_loaded();
+
+    uint16_t count = event_log_count();
+
+    /* --------------------------------------------------------------------
+     * log
+     * log tail [N]
+     * ------------------------------------------------------------------ */
+    if (argc == 1 || !strcmp_P(argv[1], PSTR("tail"))) {
+
+        static const struct arg_spec n_spec PROGMEM =
+            ARG_SPEC_INT(1, EVENT_LOG_SLOTS);
+        int32_t n = 10;
+
+        if (argc == 3) {
+            if (!arg_parse(&n_spec, argv[2], &n)) {
+                console_puts(FS(ERROR));
+                return;
+            }
+        } else if (argc > 2) {
+            console_puts(FS(WHAT));
+            return;
+        }
+
+        mini_printf(FSTR("%u record(s), %u dropped\n"),
+                    (unsigned)count,
+                    (unsigned)event_log_dropped());
+
+        if ((uint16_t)n > count)
+            n = count;
+
+        /* Oldest of the tail first */
+        for (uint16_t back = (uint16_t)n; back-- > 0; ) {
+            struct event_log_rec r;
+            if (event_log_read(back, &r))
+                log_print_rec(&r);
+        }
+        return;
+    }
+
+    /* --------------------------------------------------------------------
+     * log range YYYY-MM-DD [YYYY-MM-DD]
+     * Local calendar days, inclusive
+     * ------------------------------------------------------------------ */
+    if (!strcmp_P(argv[1], PSTR("range")) && (argc == 3 || argc == 4)) {
+
+        static const struct arg_spec date_spec[2] PROGMEM = {
+            ARG_SPEC_DATE, ARG_SPEC_DATE
+        };
+
+        int32_t dates[2];
+        int y1, mo1, d1;
+        int y2, mo2, d2;
+
+        if (!args_parse(date_spec, (uint8_t)(argc - 2), &argv[2], dates)) {
+            console_puts(FS(ERROR));
+            return;
+        }
+
+        if (argc == 3)
+            dates[1] = dates[0];
+
+        arg_date(dates[0], &y1, &mo1, &d1);
+        arg_date(dates[1], &y2, &mo2, &d2);
+
+        uint32_t from = rtc_epoch_from_ymdhms(y1, mo1, d1, 0, 0, 0,
+                                              g_cfg.tz, g_cfg.honor_dst);
+        uint32_t to   = rtc_epoch_from_ymdhms(y2, mo2, d2, 23, 59, 59,
+                                              g_cfg.tz, g_cfg.honor_dst);
+
+        if (to < from) {
+            console_puts(FS(ERROR));
+            return;
+        }
+
+        uint16_t shown = 0;
+
+        for (uint16_t back = count; back-- > 0; ) {
+            struct event_log_rec r;
+            if (!event_log_read(back, &r))
+                continue;
+
+            if (r.epoch < from || r.epoch > to)
+                continue;
+
+            log_print_rec(&r);
+            shown++;
+        }
+
+        if (shown == 0)
+            console_puts(FSTR("(no records)\n"));
+        return;
+    }
+
+    console_puts(FS(WHAT));
+}
+
+
+static void print_mah(uint32_t uah)
+{
+    mini_printf(FSTR("%lu.%03lu mAh"),
+                (unsigned long)(uah / 1000ul),
+                (unsigned long)(uah % 1000ul));
+}
+
+static void cmd_energy(int argc, char **argv)
+{
+    ensure_cfg_loaded();
+
+    static const char wake_names[ENERGY_WAKE_COUNT][7] PROGMEM = {
+        "rtc", "button", "config", "other"
+    };
+
+    energy_checkpoint(uptime_millis());
+
+    /* --------------------------------------------------------------------
+     * energy history
+     * ------------------------------------------------------------------ */
+    if (argc == 2) {
+        if (strcmp_P(argv[1], PSTR("history"))) {
+            console_puts(FS(WHAT));
+            return;
+        }
+
+        console_puts(FSTR("DATE        AWAKE_MS  MOTOR_MS  LOCK_MS  RELAY  I2C     CHARGE\n"));
+
+        bool any = false;
+
+        for (uint8_t back = ENERGY_HISTORY_DAYS; back-- > 0; ) {
+            const struct energy_day *d = energy_history(back);
+            if (!d)
+                continue;
+
+            uint32_t awake = 0;
+            for (uint8_t i = 0; i < ENERGY_WAKE_COUNT; i++)
+                awake += d->awake_ms[i];
+
+            mini_printf(FSTR("%04u-%02u-%02u  %8lu  %8lu  %7lu  %5u  %6lu  "),
+                        d->year, d->month, d->day,
+                        (unsigned long)awake,
+                        (unsigned long)d->door_motor_ms,
+                        (unsigned long)d->lock_ms,
+                        d->relay_pulses,
+                        (unsigned long)d->i2c_xfers);
+            print_mah(energy_day_uah(d, 86400ul));
+            if (d->start_s != 0)
+                console_puts(FSTR(" (partial)"));
+            console_putc('\n');
+
+            any = true;
+        }
+
+        if (!any)
+            console_puts(FSTR("(no completed days)\n"));
+        return;
+    }
+
+    /* --------------------------------------------------------------------
+     * energy
+     * ------------------------------------------------------------------ */
+
+    const struct energy_day *t = energy_today();
+
+    uint32_t now_s = 0;
+    if (rtc_time_is_set()) {
+        int h, m, s;
+        rtc_get_time(NULL, NULL, NULL, &h, &m, &s);
+        now_s = (uint32_t)h * 3600ul + (uint32_t)m * 60ul + (uint32_t)s;
+    }
+
+    if (t->year != 0) {
+        mini_printf(FSTR("TODAY %04u-%02u-%02u"), t->year, t->month, t->day);
+        if (t->start_s != 0)
+            mini_printf(FSTR(" (since %02lu:%02lu)"),
+                        (unsigned long)(t->start_s / 3600ul),
+                        (unsigned long)((t->start_s / 60ul) % 60ul));
+        console_puts(FSTR("\n\n"));
+    } else {
+        console_puts(FSTR("TODAY (date not set)\n\n"));
+    }
+
+    for (uint8_t i = 0; i < ENERGY_WAKE_COUNT; i++) {
+        console_puts(FSTR("awake "));
+        print_padded(FSTR_ARR(wake_names[i]), 9);
+        mini_printf(FSTR(": %lu ms (%u wakes)\n"),
+                    (unsigned long)t->awake_ms[i], t->wakes[i]);
+    }
+
+    mini_printf(FSTR("i2c xfers      : %lu\n"), (unsigned long)t->i2c_xfers);
+    mini_printf(FSTR("door motor     : %lu ms\n"), (unsigned long)t->door_motor_ms);
+    mini_printf(FSTR("lock           : %lu ms\n"), (unsigned long)t->lock_ms);
+    mini_printf(FSTR("relay          : %u pulses (%lu ms)\n"),
+                t->relay_pulses, (unsigned long)t->relay_ms);
+
+    console_puts(FSTR("charge so far  : "));
+    print_mah(energy_day_uah(t, now_s));
+    console_putc('\n');
+
+    uint32_t avg, days;
+    if (energy_estimate(now_s, &avg, &days)) {
+        console_puts(FSTR("avg per day    : "));
+        print_mah(avg);
+        mini_printf(FSTR("\nbattery left   : %lu days (of %u mAh)\n"),
+                    (unsigned long)days, g_cfg.batt_capacity_mah);
+    } else {
+        console_puts(FSTR("avg per day    : n/a (no full day yet)\n"));
+    }
+}
+
+
+static void cmd_latency(int argc, char **argv)
+{
+    static const char hist_names[LAT_HIST_COUNT][13] PROGMEM = {
+        "wake->action", "wake->sleep"
+    };
+    static const char src_names[LAT_SRC_COUNT][7] PROGMEM = {
+        "rtc", "button"
+    };
+
+    if (argc == 2) {
+        if (strcmp_P(argv[1], PSTR("reset"))) {
+            console_puts(FS(WHAT));
+            return;
+        }
+        latency_reset();
+        console_puts(FS(OK));
+        return;
+    }
+
+    for (uint8_t w = 0; w < LAT_HIST_COUNT; w++) {
+        for (uint8_t s = 0; s < LAT_SRC_COUNT; s++) {
+
+            const struct lat_hist *h =
+                latency_hist((lat_hist_t)w, (lat_src_t)s);
+
+            print_padded(FSTR_ARR(hist_names[w]), 14);
+            print_padded(FSTR_ARR(src_names[s]), 8);
+            mini_printf(FSTR("n=%u max=%lu us\n"),
+                        h->n, (unsigned long)h->max_us);
+
+            for (uint8_t b = 0; b < LAT_BUCKETS; b++) {
+                if (h->bucket[b] == 0)
+                    continue;
+
+                uint32_t lo = (b == 0) ? 0ul : (1ul << b);
+                mini_printf(FSTR("  >= %8lu us : %u\n"),
+                            (unsigned long)lo, h->bucket[b]);
+            }
+        }
+    }
+
+    uint32_t boot_ms = latency_boot_to_sleep_ms();
+    if (boot_ms)
+        mini_printf(FSTR("boot->sleep   %lu ms\n"), (unsigned long)boot_ms);
+    else
+        console_puts(FSTR("boot->sleep   (not yet)\n"));
+
+    mini_printf(FSTR("isr dropped   %u\n"), (unsigned)irq_queue_dropped());
+}
+
+
+static void cmd_mem(int, char **)
+{
+    struct mem_info mi;
+    mem_get_info(&mi);
+
+    mini_printf(FSTR("ram total  : %u\n"), mi.ram_total);
+    mini_printf(FSTR("static     : %u (data %u, bss %u, noinit %u)\n"),
+                mi.data + mi.bss + mi.noinit,
+                mi.data, mi.bss, mi.noinit);
+    mini_printf(FSTR("stack now  : %u\n"), mi.stack_now);
+    mini_printf(FSTR("stack peak : %u\n"), mi.stack_peak);
+    mini_printf(FSTR("free now   : %u\n"), mi.free_now);
+    mini_printf(FSTR("free min   : %u\n"), mi.free_min);
+
+    mini_printf(FSTR("last trip  : %S\n"),
+                (mem_last_trip() == MEM_TRIP_STACK_CANARY)
+                    ? FSTR("stack canary") : FSTR("none"));
+}
+
+
+static void cmd_stats(int argc, char **argv)
+{
+    if (argc == 2) {
+        if (!strcmp_P(argv[1], PSTR("save"))) {
+            metrics_snapshot();
+            console_puts(FS(OK));
+            return;
+        }
+        if (!strcmp_P(argv[1], PSTR("clear"))) {
+            metrics_clear();
+            metrics_snapshot();
+            console_puts(FS(OK));
+            return;
+        }
+        console_puts(FS(WHAT));
+        return;
+    }
+
+    for (uint8_t i = 0; i < METRIC_COUNT; i++) {
+        const char *name = metric_name_P(i);
+
+        console_puts_P(name);
+        for (size_t n = strlen_P(name); n < 18; n++)
+            console_putc(' ');
+
+        mini_printf(FSTR(": %lu\n"), (unsigned long)metric_get((metric_id_t)i));
+    }
+}
+
+
+static void cmd_power(int, char **)
+{
+    power_report();
+}
+
+
+static void cmd_macro(int argc, char **argv)
+{
+    char name[MACRO_NAME_MAX + 1];
+
+    /* macro: list names */
+    if (argc == 1) {
+        bool any = false;
+
+        for (uint8_t i = 0; i < MACRO_SLOTS; i++) {
+            if (macro_store_name(i, name)) {
+                mini_printf(FSTR("  %s\n"), name);
+                any = true;
+            }
+        }
+
+        if (!any)
+            console_puts(FSTR("(no macros)\n"));
+        return;
+    }
+
+    if (argc == 4 && !strcmp_P(argv[1], PSTR("def"))) {
+        if (!macro_store_define(argv[2], argv[3])) {
+            console_puts(FS(ERROR));
+            return;
+        }
+        console_puts(FS(OK));
+        return;
+    }
+
+    if (argc != 3) {
+        console_puts(FS(WHAT));
+        return;
+    }
+
+    if (!strcmp_P(argv[1], PSTR("del"))) {
+        console_puts(macro_store_delete(argv[2]) ? FS(OK) : FS(ERROR));
+        return;
+    }
+
+    char body[MACRO_BODY_MAX + 1];
+
+    if (!strcmp_P(argv[1], PSTR("show"))) {
+        if (!macro_store_read(argv[2], body)) {
+            console_puts(FS(ERROR));
+            return;
+        }
+        mini_printf(FSTR("%s\n"), body);
+        return;
+    }
+
+    if (!strcmp_P(argv[1], PSTR("run"))) {
+        /* One level: a macro body cannot run another macro */
+        static bool running = false;
+
+        if (running) {
+            console_puts(FSTR("ERROR: NESTED MACRO\n"));
+            return;
+        }
+
+        if (!macro_store_read(argv[2], body)) {
+            console_puts(FS(ERROR));
+            return;
+        }
+
+        running = true;
+        console_exec_line(body);
+        running = false;
+        return;
+    }
+
+    console_puts(FS(WHAT));
+}
+
+
 typedef void (*cmd_fn_t)(int argc, char **argv);
 
 typedef struct {
@@ -1491,6 +1868,7 @@ typedef struct {
       "set lat  +/-DD.DDDD\n" \
       "set lon  +/-DDD.DDDD\n" \
       "set tz   +/-HH\n" \
+      "set <energy coefficient> N\n" \
     ) \
     \
     X(config, 0, 0, cmd_config, \
@@ -1504,6 +1882,7 @@ typedef struct {
       "Commit settings", \
       "save\n" \
       "  Commit configuration to EEPROM and program RTC\n" \
+      "  (in a ';' batch or macro: once, at the end)\n" \
     ) \
     \
     X(device, 0, 3, cmd_device, \
@@ -1521,11 +1900,13 @@ typedef struct {
       "  Manually actuate the coop door\n" \
     ) \
     \
-    X(lock, 1, 2, cmd_lock, \
+    X(lock, 0, 1, cmd_lock, \
       "Manually control lock", \
+      "lock\n" \
       "lock engage\n" \
       "lock release\n" \
-      "  Manually engage or release the door lock\n" \
+      "  Show the believed lock position, or pulse the lock\n" \
+      "  (always pulses, even if already in that position)\n" \
     ) \
     \
     X(event, 0, 7, cmd_event, \
@@ -1562,6 +1943,62 @@ typedef struct {
           "sleep\n" \
           "sleep <minutes>\n" \
           "  sleep till the next resolved scheduler event (if any)\n" \
+    ) \
+    \
+    X(log, 0, 3, cmd_log, \
+      "Show door/device audit log", \
+      "log\n" \
+      "log tail [N]\n" \
+      "log range YYYY-MM-DD [YYYY-MM-DD]\n" \
+      "  Show persistent actuator log (newest last)\n" \
+    ) \
+    \
+    X(energy, 0, 1, cmd_energy, \
+      "Show energy ledger", \
+      "energy\n" \
+      "energy history\n" \
+      "  Show today's activity, estimated mAh/day and battery days left\n" \
+      "  Coefficients: set batt_mah|sleep_ua|awake_ua|console_ua|\n" \
+      "                    i2c_nc|motor_ma|lock_ma|relay_ma <N>\n" \
+    ) \
+    \
+    X(latency, 0, 1, cmd_latency, \
+      "Show wake latency histograms", \
+      "latency\n" \
+      "latency reset\n" \
+      "  Wake-to-action and wake-to-sleep times per wake source\n" \
+      "  (log2 buckets, microseconds)\n" \
+    ) \
+    \
+    X(mem, 0, 0, cmd_mem, \
+      "Show SRAM usage", \
+      "mem\n" \
+      "  Static RAM, current and peak stack depth, free SRAM\n" \
+    ) \
+    \
+    X(stats, 0, 1, cmd_stats, \
+      "Show runtime counters", \
+      "stats\n" \
+      "stats save\n" \
+      "stats clear\n" \
+      "  Show counters, snapshot them to EEPROM, or zero them\n" \
+    ) \
+    \
+    X(power, 0, 0, cmd_power, \
+      "Show peripheral power state", \
+      "power\n" \
+      "  Show which peripherals are powered and registered sleep hooks\n" \
+    ) \
+    \
+    X(macro, 0, 3, cmd_macro, \
+      "Stored command scripts", \
+      "macro\n" \
+      "macro def <name> <cmd>[; <cmd>...]\n" \
+      "macro show <name>\n" \
+      "macro run <name>\n" \
+      "macro del <name>\n" \
+      "  Scripts live in EEPROM and run as one batch:\n" \
+      "  any save inside is done once, at the end\n" \
     )
 
 
@@ -1604,13 +2041,113 @@ static void read_cmd_entry(cmd_entry_t *dst, unsigned idx)
     memcpy_P(dst, &cmd_table[idx], sizeof(cmd_entry_t));
 }
 
+
+/* ------------------------------------------------------------
+ * Perfect hash over the CMD_LIST names
+ *
+ *  - The compiler tries seeds until every name lands in its own
+ *    slot, then emits the slot → table index map (flash)
+ *  - Lookup: hash argv[0], read one slot byte, confirm with one
+ *    strcmp_P; no scan, no per-entry memcpy_P
+ *  - Adding a command re-runs the search; a failure is a build
+ *    error, fixed by growing CMD_HASH_SIZE
+ * ------------------------------------------------------------ */
+
+#define CMD_HASH_SIZE  64u          /* power of two */
+#define CMD_NO_SLOT    0xFFu
+
+/* Same function at build time (names) and run time (argv[0]) */
+static constexpr uint8_t cmd_hash(const char *s, uint16_t seed)
+{
+    uint16_t h = seed;
+
+    while (*s)
+        h = (uint16_t)(h * 31u + (uint8_t)*s++);
+
+    return (uint8_t)((h ^ (h >> 8)) & (CMD_HASH_SIZE - 1u));
+}
+
+#define CMD_NAME_STR(name, min, max, fn, short_h, long_h) #name,
+
+static constexpr const char *cmd_names[] = {
+    CMD_LIST(CMD_NAME_STR)
+};
+
+#undef CMD_NAME_STR
+
+#define CMD_NAME_COUNT (sizeof(cmd_names) / sizeof(cmd_names[0]))
+
+static_assert(CMD_NAME_COUNT < CMD_HASH_SIZE, "grow CMD_HASH_SIZE");
+
+static constexpr bool cmd_seed_ok(uint16_t seed)
+{
+    bool used[CMD_HASH_SIZE] = {};
+
+    for (unsigned i = 0; i < CMD_NAME_COUNT; i++) {
+        uint8_t h = cmd_hash(cmd_names[i], seed);
+        if (used[h])
+            return false;
+        used[h] = true;
+    }
+
+    return true;
+}
+
+static constexpr uint16_t cmd_find_seed(void)
+{
+    for (uint16_t seed = 0; seed < 4096u; seed++) {
+        if (cmd_seed_ok(seed))
+            return seed;
+    }
+
+    return 0xFFFFu;
+}
+
+static constexpr uint16_t CMD_HASH_SEED = cmd_find_seed();
+
+static_assert(CMD_HASH_SEED != 0xFFFFu,
+              "no perfect hash seed for CMD_LIST, grow CMD_HASH_SIZE");
+
+struct cmd_slot_map {
+    uint8_t idx[CMD_HASH_SIZE];     /* cmd_table index or CMD_NO_SLOT */
+};
+
+static constexpr struct cmd_slot_map cmd_build_slots(void)
+{
+    struct cmd_slot_map m = {};
+
+    for (unsigned h = 0; h < CMD_HASH_SIZE; h++)
+        m.idx[h] = CMD_NO_SLOT;
+
+    for (unsigned i = 0; i < CMD_NAME_COUNT; i++)
+        m.idx[cmd_hash(cmd_names[i], CMD_HASH_SEED)] = (uint8_t)i;
+
+    return m;
+}
+
+static const struct cmd_slot_map cmd_slots PROGMEM = cmd_build_slots();
+
+/* cmd_table index of name, or -1 */
+static int cmd_lookup(const char *name)
+{
+    uint8_t i = pgm_read_byte(&cmd_slots.idx[cmd_hash(name, CMD_HASH_SEED)]);
+
+    if (i == CMD_NO_SLOT)
+        return -1;
+
+    if (strcmp_P(name, (const char *)pgm_read_ptr(&cmd_table[i].cmd)) != 0)
+        return -1;
+
+    return i;
+}
+
 void console_help(int argc, char **argv)
 {
     cmd_entry_t e;
 
     /* help */
     if (argc == 1) {
-        console_puts("Commands:\n");
+        console_puts(FSTR("Commands:\n"));
 
         unsigned max_len = 0;
         for (unsigned i = 0; i < CMD_TABLE_LEN; i++) {
@@ -1623,7 +2160,7 @@ void console_help(int argc, char **argv)
         for (unsigned i = 0; i < CMD_TABLE_LEN; i++) {
             read_cmd_entry(&e, i);
 
-            console_puts("  ");
+            console_puts(FSTR("  "));
             console_puts_str(e.cmd);
 
             unsigned len = console_strlen(e.cmd);
@@ -1634,22 +2171,24 @@ void console_help(int argc, char **argv)
             console_putc('\n');
         }
 
-        console_puts("\nType: help <command>\n");
+        console_puts(FSTR("\nType: help <command>\n"));
         return;
     }
 
     /* help <command> */
-    for (unsigned i = 0; i < CMD_TABLE_LEN; i++) {
-        read_cmd_entry(&e, i);
+    str_to_lower(argv[1]);
 
-        if (console_strcmp(argv[1], e.cmd) == 0) {
-            if (e.help_long)
-                console_puts_str(e.help_long);
-            return;
-        }
+    int i = cmd_lookup(argv[1]);
+
+    if (i < 0) {
+        console_puts(FS(WHAT));
+        return;
     }
 
-    console_puts("?\n");
+    read_cmd_entry(&e, (unsigned)i);
+
+    if (e.help_long)
+        console_puts_str(e.help_long);
 }
 
 void console_dispatch(int argc, char **argv)
@@ -1659,27 +2198,25 @@ void console_dispatch(int argc, char **argv)
 
     str_to_lower(argv[0]);
 
-    cmd_entry_t e;
-
-    for (unsigned i = 0; i < CMD_TABLE_LEN; i++) {
-        read_cmd_entry(&e, i);
+    int i = cmd_lookup(argv[0]);
 
-        if (console_strcmp(argv[0], e.cmd) == 0) {
+    if (i < 0) {
+        console_puts(FS(WHAT));
+        return;
+    }
 
-            int args = argc - 1;
+    cmd_entry_t e;
+    read_cmd_entry(&e, (unsigned)i);
 
-            if (args < e.min_args || args > e.max_args) {
-                if (e.help_short) {
-                    console_puts_str(e.help_short);
-                    console_putc('\n');
-                }
-                return;
-            }
+    int args = argc - 1;
 
-            e.handler(argc, argv);
-            return;
+    if (args < e.min_args || args > e.max_args) {
+        if (e.help_short) {
+            console_puts_str(e.help_short);
+            console_putc('\n');
         }
+        return;
     }
 
-    console_puts("?\n");
+    e.handler(argc, argv);
 }
@@ -9,13 +9,26 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-18
  */
 
 #pragma once
+
+#include <stdint.h>
+
+#include "flash_str.h"
+
 int  console_getc(void);
 void console_putc(char c);
+void console_putc_raw(uint8_t b);      /* binary: no newline translation */
 void console_puts(const char *s);
+void console_puts_P(const char *s);
+
+/* Flash string: same call, flash reader */
+static inline void console_puts(flash_str s)
+{
+    console_puts_P(flash_ptr(s));
+}
 
 
 void console_terminal_init(void);
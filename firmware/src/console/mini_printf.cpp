@@ -9,16 +9,19 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-18
  */
 
 #include <stdarg.h>
 #include <stdbool.h>
 #include <stdint.h>
 #include "console_io.h"
+#include "cfmt.h"
+
+#include <avr/pgmspace.h>
 
 /* print unsigned int with optional zero padding */
-static void put_uint_pad(unsigned int v, unsigned int width, char pad)
+void mini_put_uint(unsigned int v, unsigned int width, char pad)
 {
     char buf[10];
     unsigned int i = 0;
@@ -39,17 +42,17 @@ static void put_uint_pad(unsigned int v, unsigned int width, char pad)
         console_putc(buf[i]);
 }
 
-static void put_int_pad(int v, unsigned int width, char pad)
+void mini_put_int(int v, unsigned int width, char pad)
 {
     if (v < 0) {
         console_putc('-');
-        put_uint_pad((unsigned int)(-v), width ? width - 1 : 0, pad);
+        mini_put_uint((unsigned int)(-v), width ? width - 1 : 0, pad);
     } else {
-        put_uint_pad((unsigned int)v, width, pad);
+        mini_put_uint((unsigned int)v, width, pad);
     }
 }
 
-static void put_latlon_e4(int32_t v)
+void mini_put_latlon_e4(int32_t v)
 {
     if (v < 0) {
         console_putc('-');
@@ -59,13 +62,13 @@ static void put_latlon_e4(int32_t v)
     int32_t deg = v / 10000;
     int32_t frac = v % 10000;
 
-    put_int_pad(deg, 0, ' ');
+    mini_put_int(deg, 0, ' ');
     console_putc('.');
-    put_uint_pad((unsigned int)frac, 4, '0');
+    mini_put_uint((unsigned int)frac, 4, '0');
 }
 
 /* print unsigned long (32-bit) with optional zero padding */
-static void put_ulong_pad(uint32_t v, unsigned int width, char pad)
+void mini_put_ulong(uint32_t v, unsigned int width, char pad)
 {
     char buf[10];
     unsigned int i = 0;
@@ -86,32 +89,48 @@ static void put_ulong_pad(uint32_t v, unsigned int width, char pad)
         console_putc(buf[i]);
 }
 
-static void put_long_pad(int32_t v, unsigned int width, char pad)
+void mini_put_long(int32_t v, unsigned int width, char pad)
 {
     if (v < 0) {
         console_putc('-');
-        put_ulong_pad((uint32_t)(-v), width ? width - 1 : 0, pad);
+        mini_put_ulong((uint32_t)(-v), width ? width - 1 : 0, pad);
     } else {
-        put_ulong_pad((uint32_t)v, width, pad);
+        mini_put_ulong((uint32_t)v, width, pad);
     }
 }
 
-static void put_hex8(uint8_t v)
+void mini_put_hex8(uint8_t v)
 {
     const char *hex = "0123456789ABCDEF";
     console_putc(hex[(v >> 4) & 0x0F]);
     console_putc(hex[v & 0x0F]);
 }
 
-void mini_printf(const char *fmt, ...)
+/* Literal segment of a cfmt() format (flash) */
+void mini_put_P(const char *p, uint8_t n)
 {
-    va_list ap;
-    va_start(ap, fmt);
+    while (n--)
+        console_putc((char)pgm_read_byte(p++));
+}
+
+/*
+ * Shared engine. The format is read through fmt_at(), so the
+ * same parser serves RAM and flash formats.
+ */
+static inline char fmt_at(const char *p, bool pgm)
+{
+    return pgm ? (char)pgm_read_byte(p) : *p;
+}
 
-    while (*fmt) {
+static void mini_vprintf(const char *fmt, bool pgm, va_list ap)
+{
+    char c;
 
-        if (*fmt != '%') {
-            console_putc(*fmt++);
+    while ((c = fmt_at(fmt, pgm)) != 0) {
+
+        if (c != '%') {
+            console_putc(c);
+            fmt++;
             continue;
         }
 
@@ -119,61 +138,68 @@ void mini_printf(const char *fmt, ...)
 
         /* parse zero pad */
         char pad = ' ';
-        if (*fmt == '0') {
+        if (fmt_at(fmt, pgm) == '0') {
             pad = '0';
             fmt++;
         }
 
         /* parse width */
         unsigned int width = 0;
-        while (*fmt >= '0' && *fmt <= '9') {
-            width = width * 10 + (unsigned int)(*fmt - '0');
+        while ((c = fmt_at(fmt, pgm)) >= '0' && c <= '9') {
+            width = width * 10 + (unsigned int)(c - '0');
             fmt++;
         }
 
         /* parse optional long modifier */
         bool long_flag = false;
-        if (*fmt == 'l') {
+        if (fmt_at(fmt, pgm) == 'l') {
             long_flag = true;
             fmt++;
         }
 
-        switch (*fmt) {
+        switch (fmt_at(fmt, pgm)) {
 
         case 's':
             console_puts(va_arg(ap, const char *));
             break;
 
+        case 'S':
+            console_puts(va_arg(ap, flash_str));
+            break;
+
         case 'c':
             console_putc((char)va_arg(ap, int));
             break;
 
         case 'u':
             if (long_flag)
-                put_ulong_pad(va_arg(ap, uint32_t), width, pad);
+                mini_put_ulong(va_arg(ap, uint32_t), width, pad);
             else
-                put_uint_pad(va_arg(ap, unsigned int), width, pad);
+                mini_put_uint(va_arg(ap, unsigned int), width, pad);
             break;
 
         case 'd':
             if (long_flag)
-                put_long_pad(va_arg(ap, int32_t), width, pad);
+                mini_put_long(va_arg(ap, int32_t), width, pad);
             else
-                put_int_pad(va_arg(ap, int), width, pad);
+                mini_put_int(va_arg(ap, int), width, pad);
             break;
 
         case 'L':
-            put_latlon_e4(va_arg(ap, int32_t));
+            mini_put_latlon_e4(va_arg(ap, int32_t));
             break;
 
         case 'x':
-            put_hex8((uint8_t)va_arg(ap, unsigned int));
+            mini_put_hex8((uint8_t)va_arg(ap, unsigned int));
             break;
 
         case '%':
             console_putc('%');
             break;
 
+        case 0:
+            return;     /* format ends after '%' */
+
         default:
             console_putc('?');
             break;
@@ -181,6 +207,20 @@ void mini_printf(const char *fmt, ...)
 
         fmt++;
     }
+}
 
+void mini_printf(const char *fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    mini_vprintf(fmt, false, ap);
+    va_end(ap);
+}
+
+void mini_printf(flash_str fmt, ...)
+{
+    va_list ap;
+    va_start(ap, fmt);
+    mini_vprintf(flash_ptr(fmt), true, ap);
     va_end(ap);
 }
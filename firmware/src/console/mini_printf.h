@@ -9,7 +9,7 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-18
  */
 
 
@@ -29,6 +29,7 @@
   * Supported format specifiers:
   *
   *   %s      const char *
+  *   %S      flash_str (flash_str.h)
   *   %c      char
   *   %u      unsigned int (16-bit on AVR)
   *   %d      int (16-bit on AVR)
@@ -67,8 +68,16 @@
   *
   * This is intentionally minimal. If you need more,
   * you are probably on the wrong platform.
+  *
+  * For fixed formats prefer cfmt() (cfmt.h): same conversions,
+  * parsed and type-checked at compile time, format kept in flash.
   */
 
 #pragma once
 
+#include "flash_str.h"
+
 void mini_printf(const char *fmt, ...);
+
+/* Format in flash: mini_printf(FSTR("..."), ...) */
+void mini_printf(flash_str fmt, ...);
@@ -9,13 +9,14 @@
  *  - No scheduling or event knowledge
  *  - Scheduler decides WHAT, devices decide HOW
  *
- * Updated: 2026-01-01
+ * Updated: 2026-10-18
  */
 
 #pragma once
 #include <stddef.h>
 #include <stdint.h>
 #include "device_ids.h"
+#include "flash_str.h"
 
 /* Device-visible state */
 typedef enum {
@@ -24,14 +25,32 @@ typedef enum {
     DEV_STATE_ON
 } dev_state_t;
 
-/* Generic device vtable */
+/* device_tick(): no device has work pending */
+#define DEVICE_NO_DEADLINE  0xFFFFFFFFul
+
+/*
+ * Generic device vtable
+ *
+ * Built-in devices also expose their hooks to the compile-time
+ * registry (device_registry.h); the vtable carries name and state
+ * strings for them, and everything for vtable-only devices.
+ */
 typedef struct {
-    const       char *name;
+    flash_str   name;
     uint8_t     deviceID;
     void        (*init)(void);
     dev_state_t (*get_state)(void);
     void        (*set_state)(dev_state_t state);
-    const char *(*state_string)(dev_state_t state);
+    flash_str   (*state_string)(dev_state_t state);
     void        (*tick)(uint32_t now_ms);
+
+    /* When tick() next has work: true + absolute uptime ms, or
+       false if nothing is due. NULL: tick() runs every pass */
+    bool        (*next_deadline_ms)(uint32_t now_ms, uint32_t *deadline_ms);
+
     bool        (*is_busy)(void);
+
+    /* Warm reset: bring up hardware and adopt a known settled
+       state WITHOUT driving it (replaces init; may be NULL) */
+    void        (*restore)(dev_state_t state);
 } Device;
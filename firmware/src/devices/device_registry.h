@@ -0,0 +1,325 @@
+/*
+ * device_registry.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Compile-time device registry
+ *
+ * Design:
+ *  - The device set is a type list (registered_devices), fixed at
+ *    build time; there is no runtime table to fill or walk
+ *  - Each built-in device is a traits struct: a constant ID, its
+ *    Device vtable (name / state strings), and the hot hooks as
+ *    static member functions
+ *  - A hook that a device does not declare is detected at compile
+ *    time and generates no code: no NULL test, no call
+ *  - tick / busy / init expand to straight-line direct calls in
+ *    list order
+ *  - tick runs only when a device's next_deadline_ms() has passed;
+ *    a device with tick but no deadline hook is ticked every pass
+ *
+ * Notes:
+ *  - IDs stay sparse and explicit (device_ids.h); the list must
+ *    be in ascending ID order (checked)
+ *  - Devices that only provide a C-style Device vtable (see
+ *    foo_device.cpp) register through vtable_dev<>, which keeps
+ *    the old NULL-checked indirect calls for that device only
+ *  - Internal to the device layer and schedule_apply; everything
+ *    else uses devices.h
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "device.h"
+
+/* --------------------------------------------------------------------------
+ * Device vtables (name, state strings; provided by each device)
+ * -------------------------------------------------------------------------- */
+
+extern Device door_device;
+extern Device led_device;
+extern Device relay1_device;
+extern Device relay2_device;
+//extern Device foo_device;
+
+/* --------------------------------------------------------------------------
+ * Built-in devices (hooks defined in the device's .cpp)
+ * -------------------------------------------------------------------------- */
+
+struct door_dev {
+    static constexpr uint8_t       id = DEVICE_ID_DOOR;
+    static constexpr const Device *vt = &door_device;
+
+    static void        init(void);
+    static void        restore(dev_state_t state);
+    static dev_state_t get_state(void);
+    static void        set_state(dev_state_t state);
+    static bool        is_busy(void);
+    /* no tick: timer driven (timer.h) */
+};
+
+struct led_dev {
+    static constexpr uint8_t       id = DEVICE_ID_LED;
+    static constexpr const Device *vt = &led_device;
+
+    static void        init(void);
+    static dev_state_t get_state(void);
+    static void        tick(uint32_t now_ms);
+    static bool        next_deadline_ms(uint32_t now_ms, uint32_t *deadline_ms);
+};
+
+struct relay1_dev {
+    static constexpr uint8_t       id = DEVICE_ID_RELAY1;
+    static constexpr const Device *vt = &relay1_device;
+
+    static void        init(void);
+    static void        restore(dev_state_t state);
+    static dev_state_t get_state(void);
+    static void        set_state(dev_state_t state);
+};
+
+struct relay2_dev {
+    static constexpr uint8_t       id = DEVICE_ID_RELAY2;
+    static constexpr const Device *vt = &relay2_device;
+
+    static void        init(void);
+    static void        restore(dev_state_t state);
+    static dev_state_t get_state(void);
+    static void        set_state(dev_state_t state);
+};
+
+/* --------------------------------------------------------------------------
+ * Vtable-only devices (C-style extension, runtime dispatch)
+ * -------------------------------------------------------------------------- */
+
+template <uint8_t ID, const Device *VT>
+struct vtable_dev {
+    static constexpr uint8_t       id = ID;
+    static constexpr const Device *vt = VT;
+
+    static void init(void)
+    {
+        if (VT->init)
+            VT->init();
+    }
+
+    static void restore(dev_state_t state)
+    {
+        if (VT->restore)
+            VT->restore(state);
+        else
+            init();
+    }
+
+    static dev_state_t get_state(void)
+    {
+        return VT->get_state ? VT->get_state() : DEV_STATE_UNKNOWN;
+    }
+
+    static void set_state(dev_state_t state)
+    {
+        if (VT->set_state)
+            VT->set_state(state);
+    }
+
+    static void tick(uint32_t now_ms)
+    {
+        if (VT->tick)
+            VT->tick(now_ms);
+    }
+
+    static bool next_deadline_ms(uint32_t now_ms, uint32_t *deadline_ms)
+    {
+        if (VT->next_deadline_ms)
+            return VT->next_deadline_ms(now_ms, deadline_ms);
+
+        *deadline_ms = now_ms;          /* tick every pass */
+        return VT->tick != NULL;
+    }
+
+    static bool is_busy(void)
+    {
+        return VT->is_busy && VT->is_busy();
+    }
+};
+
+/* --------------------------------------------------------------------------
+ * Hook detection (no <type_traits> on avr-libc)
+ * -------------------------------------------------------------------------- */
+
+template <typename...> using dev_void_t = void;
+
+#define DEV_HOOK_TRAIT(hook)                                            \
+    template <typename T, typename = void>                              \
+    struct dev_has_##hook { static constexpr bool value = false; };     \
+    template <typename T>                                               \
+    struct dev_has_##hook<T, dev_void_t<decltype(&T::hook)>> {          \
+        static constexpr bool value = true;                             \
+    };
+
+DEV_HOOK_TRAIT(init)
+DEV_HOOK_TRAIT(restore)
+DEV_HOOK_TRAIT(get_state)
+DEV_HOOK_TRAIT(set_state)
+DEV_HOOK_TRAIT(tick)
+DEV_HOOK_TRAIT(next_deadline_ms)
+DEV_HOOK_TRAIT(is_busy)
+
+#undef DEV_HOOK_TRAIT
+
+/* --------------------------------------------------------------------------
+ * Per-device dispatch (absent hook → nothing / safe default)
+ * -------------------------------------------------------------------------- */
+
+template <typename D>
+inline void dev_init(const uint8_t *warm)
+{
+    if constexpr (dev_has_restore<D>::value) {
+        if (warm && warm[D::id] != DEV_STATE_UNKNOWN) {
+            D::restore((dev_state_t)warm[D::id]);
+            return;
+        }
+    }
+
+    if constexpr (dev_has_init<D>::value)
+        D::init();
+}
+
+template <typename D>
+inline dev_state_t dev_get_state(void)
+{
+    if constexpr (dev_has_get_state<D>::value)
+        return D::get_state();
+    else
+        return DEV_STATE_UNKNOWN;
+}
+
+/* false if the device cannot be set */
+template <typename D>
+inline bool dev_set_state(dev_state_t state)
+{
+    if constexpr (dev_has_set_state<D>::value) {
+        D::set_state(state);
+        return true;
+    } else {
+        (void)state;
+        return false;
+    }
+}
+
+/*
+ * Tick D if its deadline has passed, then fold its next deadline
+ * into *left (ms from now_ms).
+ */
+template <typename D>
+inline void dev_tick(uint32_t now_ms, uint32_t *left)
+{
+    if constexpr (!dev_has_tick<D>::value) {
+        (void)now_ms;
+        (void)left;
+    } else if constexpr (!dev_has_next_deadline_ms<D>::value) {
+        D::tick(now_ms);
+        *left = 0;
+    } else {
+        uint32_t dl;
+
+        if (!D::next_deadline_ms(now_ms, &dl))
+            return;
+
+        if ((int32_t)(now_ms - dl) >= 0) {
+            D::tick(now_ms);
+
+            if (!D::next_deadline_ms(now_ms, &dl))
+                return;
+        }
+
+        uint32_t l = ((int32_t)(dl - now_ms) > 0) ? dl - now_ms : 0u;
+
+        if (l < *left)
+            *left = l;
+    }
+}
+
+template <typename D>
+inline bool dev_is_busy(void)
+{
+    if constexpr (dev_has_is_busy<D>::value)
+        return D::is_busy();
+    else
+        return false;
+}
+
+/* --------------------------------------------------------------------------
+ * Device set
+ * -------------------------------------------------------------------------- */
+
+template <typename... D>
+constexpr bool dev_ids_valid(void)
+{
+    constexpr uint8_t ids[] = { D::id..., DEVICE_ID_TABLE_SIZE };
+
+    for (uint8_t i = 0; i < sizeof...(D); i++) {
+        if (ids[i] == DEVICE_ID_NONE || ids[i] >= ids[i + 1])
+            return false;
+    }
+    return true;
+}
+
+template <typename... D>
+struct device_set {
+
+    /* Bit per registered ID (enumeration) */
+    static constexpr uint32_t mask = (0UL | ... | (1UL << D::id));
+
+    static void init(const uint8_t *warm) { (dev_init<D>(warm), ...); }
+
+    /* ms until the earliest device deadline, DEVICE_NO_DEADLINE if none */
+    static uint32_t tick(uint32_t now_ms)
+    {
+        uint32_t left = DEVICE_NO_DEADLINE;
+
+        (dev_tick<D>(now_ms, &left), ...);
+        return left;
+    }
+
+    static bool busy(void) { return (false || ... || dev_is_busy<D>()); }
+
+    /* f(D{}) for every device, in ID order */
+    template <typename F>
+    static void each(F f) { (f(D{}), ...); }
+
+    /* f(D{}) for the device with this ID; false if none */
+    template <typename F>
+    static bool with(uint8_t id, F f)
+    {
+        return (false || ... || (id == D::id && (f(D{}), true)));
+    }
+
+    /* Vtable by ID (cold paths: names, state strings) */
+    static const Device *vtable(uint8_t id)
+    {
+        const Device *vt = nullptr;
+        (void)(false || ... || (id == D::id && (vt = D::vt, true)));
+        return vt;
+    }
+
+    static_assert(DEVICE_ID_TABLE_SIZE <= 32, "device mask is 32 bits");
+    static_assert(dev_ids_valid<D...>(),
+                  "device IDs must be unique, ascending, non-zero");
+};
+
+/* --------------------------------------------------------------------------
+ * Registered devices (ascending ID)
+ * -------------------------------------------------------------------------- */
+
+typedef device_set<
+    door_dev,
+    led_dev,
+    relay1_dev,
+    relay2_dev
+//  , vtable_dev<DEVICE_ID_FOO, &foo_device>
+> registered_devices;
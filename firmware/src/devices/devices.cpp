@@ -4,58 +4,33 @@
  * Project: Chicken Coop Controller
  * Purpose: Device registry implementation
  *
- * Updated: 2026-01-08
+ * Notes:
+ *  - By-ID calls resolve to a compare chain over the registered
+ *    IDs and a direct call; tick / busy have no loop at all
+ *
+ * Updated: 2026-10-18
  */
 
 #include "devices.h"
+#include "device_registry.h"
 
 #include <stdint.h>
 #include <stddef.h>
 #include <string.h>
 
 /* --------------------------------------------------------------------------
- * Device implementations (provided elsewhere)
- * -------------------------------------------------------------------------- */
-
-extern const Device door_device;
-extern const Device led_device;
-extern const Device relay1_device;
-extern const Device relay2_device;
-//extern const Device foo_device;
-
-/* --------------------------------------------------------------------------
- * Registry table (sparse, explicit IDs)
+ * Registry (compile-time, see device_registry.h)
  * -------------------------------------------------------------------------- */
 
-static const Device *devices[DEVICE_ID_TABLE_SIZE];
+typedef registered_devices reg;
 
 /* --------------------------------------------------------------------------
  * Initialization
  * -------------------------------------------------------------------------- */
 
-void device_init(void)
+void device_init(const uint8_t *warm)
 {
-    /* Clear registry */
-    for (size_t i = 0; i < DEVICE_ID_TABLE_SIZE; i++) {
-        devices[i] = NULL;
-    }
-
-    /* Register devices by explicit ID */
-    devices[DEVICE_ID_DOOR]   = &door_device;
-    devices[DEVICE_ID_LED]    = &led_device;
-    devices[DEVICE_ID_RELAY1] = &relay1_device;
-    devices[DEVICE_ID_RELAY2] = &relay2_device;
-  //  devices[DEVICE_ID_FOO]    = &foo_device;
-
-    /* Initialize registered devices only */
-    for (size_t i = 0; i < DEVICE_ID_TABLE_SIZE; i++) {
-        const Device *dev = devices[i];
-        if (!dev)
-            continue;
-
-        if (dev->init)
-            dev->init();
-    }
+    reg::init(warm);
 }
 
 /* --------------------------------------------------------------------------
@@ -64,10 +39,12 @@ void device_init(void)
 
 static const Device *device_by_id(uint8_t id)
 {
-    if (id >= DEVICE_ID_TABLE_SIZE)
-        return NULL;
+    return reg::vtable(id);
+}
 
-    return devices[id];
+static bool registered(uint8_t id)
+{
+    return id < DEVICE_ID_TABLE_SIZE && (reg::mask & (1UL << id));
 }
 
 
@@ -81,7 +58,7 @@ bool device_enum_first(uint8_t *out_id)
         return false;
 
     for (uint8_t id = 0; id < DEVICE_ID_TABLE_SIZE; id++) {
-        if (devices[id]) {
+        if (registered(id)) {
             *out_id = id;
             return true;
         }
@@ -99,7 +76,7 @@ bool device_enum_next(uint8_t cur_id, uint8_t *out_id)
         return false;
 
     for (uint8_t id = cur_id + 1; id < DEVICE_ID_TABLE_SIZE; id++) {
-        if (devices[id]) {
+        if (registered(id)) {
             *out_id = id;
             return true;
         }
@@ -118,11 +95,11 @@ bool device_lookup_id(const char *name, uint8_t *out_id)
         return false;
 
     for (uint8_t id = 0; id < DEVICE_ID_TABLE_SIZE; id++) {
-        const Device *dev = devices[id];
+        const Device *dev = device_by_id(id);
         if (!dev || !dev->name)
             continue;
 
-        if (strcmp(dev->name, name) == 0) {
+        if (strcmp_P(name, flash_ptr(dev->name)) == 0) {
             *out_id = id;
             return true;
         }
@@ -135,16 +112,9 @@ bool device_lookup_id(const char *name, uint8_t *out_id)
  * Periodic service
  * -------------------------------------------------------------------------- */
 
-void device_tick(uint32_t now_ms)
+uint32_t device_tick(uint32_t now_ms)
 {
-    for (size_t i = 0; i < DEVICE_ID_TABLE_SIZE; i++) {
-        const Device *dev = devices[i];
-        if (!dev)
-            continue;
-
-        if (dev->tick)
-            dev->tick(now_ms);
-    }
+    return reg::tick(now_ms);
 }
 
 /* --------------------------------------------------------------------------
@@ -153,12 +123,13 @@ void device_tick(uint32_t now_ms)
 
 bool device_set_state_by_id(uint8_t id, dev_state_t state)
 {
-    const Device *dev = device_by_id(id);
-    if (!dev || !dev->set_state)
-        return false;
+    bool ok = false;
 
-    dev->set_state(state);
-    return true;
+    reg::with(id, [&](auto d) {
+        ok = dev_set_state<decltype(d)>(state);
+    });
+
+    return ok;
 }
 
 bool device_get_state_by_id(uint8_t id, dev_state_t *out_state)
@@ -166,22 +137,14 @@ bool device_get_state_by_id(uint8_t id, dev_state_t *out_state)
     if (!out_state)
         return false;
 
-    const Device *dev = device_by_id(id);
-    if (!dev)
-        return false;
-
-    if (!dev->get_state) {
-        *out_state = DEV_STATE_UNKNOWN;
-        return true;
-    }
-
-    *out_state = dev->get_state();
-    return true;
+    return reg::with(id, [&](auto d) {
+        *out_state = dev_get_state<decltype(d)>();
+    });
 }
 
 bool device_get_state_string(uint8_t id,
                              dev_state_t state,
-                             const char **out_string)
+                             flash_str *out_string)
 {
     if (!out_string)
         return false;
@@ -194,7 +157,7 @@ bool device_get_state_string(uint8_t id,
     return (*out_string != NULL);
 }
 
-bool device_name(uint8_t id, const char **out_name)
+bool device_name(uint8_t id, flash_str *out_name)
 {
     if (!out_name)
         return false;
@@ -228,11 +191,11 @@ bool device_parse_state_by_id(uint8_t id,
              s <= DEV_STATE_ON;
              s = (dev_state_t)(s + 1)) {
 
-            const char *name = dev->state_string(s);
+            flash_str name = dev->state_string(s);
             if (!name)
                 continue;
 
-            if (!strcasecmp(arg, name)) {
+            if (!strcasecmp_P(arg, flash_ptr(name))) {
                 *out = s;
                 return true;
             }
@@ -240,12 +203,12 @@ bool device_parse_state_by_id(uint8_t id,
     }
 
     /* Generic fallback */
-    if (!strcasecmp(arg, "on")) {
+    if (!strcasecmp_P(arg, PSTR("on"))) {
         *out = DEV_STATE_ON;
         return true;
     }
 
-    if (!strcasecmp(arg, "off")) {
+    if (!strcasecmp_P(arg, PSTR("off"))) {
         *out = DEV_STATE_OFF;
         return true;
     }
@@ -265,26 +228,20 @@ bool device_parse_state_by_id(uint8_t id,
  *   true  → System must remain awake
  *   false → Safe to enter sleep
  */
-bool devices_busy(void){
-
-    for (size_t i = 0; i < DEVICE_ID_TABLE_SIZE; i++) {
-        const Device *dev = devices[i];
-        if (!dev)
-            continue;
-
-        if (dev->is_busy)
-            if(dev->is_busy()) return true;
-    }
-    return false;
+bool devices_busy(void)
+{
+    return reg::busy();
 }
 
 
 
 bool device_is_busy(uint8_t id)
 {
-    const Device *dev = device_by_id(id);
-    if (!dev || !dev->is_busy)
-        return false;
+    bool busy = false;
+
+    reg::with(id, [&](auto d) {
+        busy = dev_is_busy<decltype(d)>();
+    });
 
-    return dev->is_busy;
+    return busy;
 }
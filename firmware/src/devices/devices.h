@@ -5,7 +5,8 @@
  * Purpose: Device registry public interface
  *
  * Design goals:
- *  - Static, sparse device table
+ *  - Static, sparse device set, fixed at compile time
+ *    (device_registry.h)
  *  - Explicit device IDs (not positional)
  *  - No exposure of Device struct to callers
  *  - Enumeration instead of index probing
@@ -16,7 +17,7 @@
  *  - No dynamic memory
  *  - Caller must not assume contiguous IDs
  *
- * Updated: 2026-01-08
+ * Updated: 2026-10-18
  */
 
 #pragma once
@@ -33,8 +34,12 @@
 /*
  * Initialize device registry and all registered devices.
  * Must be called once at boot.
+ *
+ * warm: per-ID dev_state_t from a warm-reset snapshot, or NULL.
+ * A device with a restore() and a known warm state adopts it
+ * without actuating; every other device gets its normal init().
  */
-void device_init(void);
+void device_init(const uint8_t *warm);
 
 /* --------------------------------------------------------------------------
  * Enumeration
@@ -109,7 +114,7 @@ bool device_get_state_by_id(uint8_t id, dev_state_t *out_state);
  */
 bool device_get_state_string(uint8_t id,
                              dev_state_t state,
-                             const char **out_string);
+                             flash_str *out_string);
 
 /*
  * Get device name.
@@ -118,7 +123,7 @@ bool device_get_state_string(uint8_t id,
  *  - true  if device exists
  *  - false otherwise
  */
-bool device_name(uint8_t id, const char **out_name);
+bool device_name(uint8_t id, flash_str *out_name);
 
 /*
  * Parse a state argument for a device.
@@ -137,9 +142,17 @@ bool device_parse_state_by_id(uint8_t id,
  * -------------------------------------------------------------------------- */
 
 /*
- * Call tick() on all registered devices that provide one.
+ * Call tick() on the registered devices that are due.
+ *
+ * A device with next_deadline_ms() is ticked only once its deadline
+ * has passed; one without is ticked on every call.
+ *
+ * Returns:
+ *  - ms until the earliest device deadline (0 = wants the next
+ *    pass of the main loop)
+ *  - DEVICE_NO_DEADLINE if no device has work pending
  */
-void device_tick(uint32_t now_ms);
+uint32_t device_tick(uint32_t now_ms);
 
 /*
  * devices_busy()
@@ -9,22 +9,23 @@
  *  - Delegates motion and timing to door_state_machine
  *  - No direct hardware control here
  *
- * Updated: 2026-01-06
+ * Updated: 2026-10-18
  */
 
 #include "device.h"
+#include "device_registry.h"
 #include "door_state_machine.h"
 
 /*
  * Device-visible state only.
  * This reflects settled truth, not motion.
  */
-static dev_state_t door_get_state(void)
+dev_state_t door_dev::get_state(void)
 {
     return door_sm_get_state();
 }
 
-static void door_set_state(dev_state_t state)
+void door_dev::set_state(dev_state_t state)
 {
     /*
      * Only ON/OFF are meaningful requests.
@@ -34,38 +35,39 @@ static void door_set_state(dev_state_t state)
         door_sm_request(state);
 }
 
-static const char *door_state_string(dev_state_t state)
+static flash_str door_state_string(dev_state_t state)
 {
     if (state == DEV_STATE_ON)
-        return "OPEN";
+        return FSTR("OPEN");
 
     if (state == DEV_STATE_OFF)
-        return "CLOSED";
+        return FSTR("CLOSED");
 
     /* If unsettled, reflect motion truth */
     door_motion_t m = door_sm_get_motion();
 
     switch (m) {
-    case DOOR_MOVING_OPEN:     return "OPENING";
-    case DOOR_MOVING_CLOSE:    return "CLOSING";
-    case DOOR_POSTCLOSE_LOCK:  return "LOCKING";
-    case DOOR_IDLE_UNKNOWN:    return "UNKNOWN";
-    default:                   return "TRANSITION";
+    case DOOR_MOVING_OPEN:     return FSTR("OPENING");
+    case DOOR_MOVING_CLOSE:    return FSTR("CLOSING");
+    case DOOR_POSTCLOSE_LOCK:  return FSTR("LOCKING");
+    case DOOR_IDLE_UNKNOWN:    return FS(UNKNOWN);
+    default:                   return FSTR("TRANSITION");
     }
 }
 
 
-static void door_init(void)
+void door_dev::init(void)
 {
     door_sm_init();
 }
 
-static void door_tick(uint32_t now_ms)
+void door_dev::restore(dev_state_t state)
 {
-    door_sm_tick(now_ms);
+    door_sm_init();
+    door_sm_restore(state);
 }
 
-static bool door_busy()
+bool door_dev::is_busy(void)
 {
 
     bool is_busy = true;
@@ -91,13 +93,17 @@ static bool door_busy()
  * Device registration
  * -------------------------------------------------------------------------- */
 
+static const char door_name[] PROGMEM = "door";
+
 Device door_device = {
-    .name         = "door",
+    .name         = FSTR_ARR(door_name),
     .deviceID     = DEVICE_ID_DOOR,
-    .init         = door_init,
-    .get_state    = door_get_state,
-    .set_state    = door_set_state,
+    .init         = door_dev::init,
+    .get_state    = door_dev::get_state,
+    .set_state    = door_dev::set_state,
     .state_string = door_state_string,
-    .tick         = door_tick,
-    .is_busy      = door_busy
+    .tick         = NULL,         /* task driven (task.h) */
+    .next_deadline_ms = NULL,
+    .is_busy      = door_dev::is_busy,
+    .restore      = door_dev::restore
 };
@@ -12,6 +12,10 @@
 #include "door_lock.h"
 #include "config.h"
 #include "uptime.h"
+#include "energy.h"
+#include "warm_state.h"
+#include "metrics.h"
+#include "task.h"
 
 /* --------------------------------------------------------------------------
  * Internal state
@@ -19,7 +23,36 @@
 
 static door_motion_t g_motion        = DOOR_IDLE_UNKNOWN;
 static dev_state_t   g_settled_state = DEV_STATE_UNKNOWN;
-static uint32_t      g_motion_t0_ms  = 0;
+
+/*
+ * Motion sequence: unlock → drive → (settle → lock), one task.
+ * g_target / g_reverse are its arguments.
+ */
+static struct task   g_seq;
+static dev_state_t   g_target        = DEV_STATE_UNKNOWN;
+static bool          g_reverse       = false;   /* dead-time first */
+static uint16_t      g_lock_ms       = 0;       /* lock pulse on-time */
+
+static task_status_t door_sequence(struct task *t);
+
+/* Motor on-time accounting (energy ledger) */
+static bool          g_motor_on      = false;
+static uint32_t      g_motor_on_ms   = 0;
+
+/*
+ * Estimated position: open-direction travel time from CLOSED,
+ * 0 .. door_travel_ms. Integrated from motor on-time; only
+ * trusted after a settled end position (boot or full stroke).
+ */
+static uint16_t      g_pos_ms        = 0;
+static bool          g_pos_known     = false;
+
+/* Planned on-time of the current motion */
+static uint16_t      g_drive_ms      = 0;
+
+/* Extra drive past the estimate: travel / DIV, at least MIN */
+#define DOOR_POS_MARGIN_DIV     8u
+#define DOOR_POS_MARGIN_MIN_MS  500u
 
 /* Optional delay before locking (settle time) */
 #define POSTCLOSE_DELAY_MS  250u
@@ -67,9 +100,82 @@ static void set_motion(door_motion_t m)
     update_led(m);
 }
 
+/* Position after on_ms of drive in the current direction */
+static uint16_t pos_advance(uint16_t pos, uint32_t on_ms)
+{
+    uint16_t travel = g_cfg.door_travel_ms;
+
+    if (pos > travel)
+        pos = travel;
+
+    if (on_ms > travel)
+        on_ms = travel;
+
+    if (g_motion == DOOR_MOVING_OPEN)
+        return (uint16_t)((pos + on_ms > travel) ? travel : pos + on_ms);
+
+    if (g_motion == DOOR_MOVING_CLOSE)
+        return (uint16_t)((on_ms > pos) ? 0 : pos - on_ms);
+
+    return pos;
+}
+
+static void pos_settle(bool open)
+{
+    g_pos_ms    = open ? g_cfg.door_travel_ms : 0;
+    g_pos_known = true;
+}
+
+/*
+ * On-time for a motion toward open / closed: the estimated
+ * remaining distance plus margin, never more than a full stroke.
+ * Full stroke while the position is unknown.
+ */
+static uint16_t drive_time_ms(bool open)
+{
+    uint16_t travel = g_cfg.door_travel_ms;
+
+    if (!g_pos_known)
+        return travel;
+
+    uint16_t pos    = (g_pos_ms > travel) ? travel : g_pos_ms;
+    uint16_t remain = open ? (uint16_t)(travel - pos) : pos;
+
+    uint16_t margin = travel / DOOR_POS_MARGIN_DIV;
+    if (margin < DOOR_POS_MARGIN_MIN_MS)
+        margin = DOOR_POS_MARGIN_MIN_MS;
+
+    uint32_t ms = (uint32_t)remain + margin;
+    if (ms > travel)
+        ms = travel;
+
+    metric_add(METRIC_DOOR_SAVED_MS, travel - ms);
+
+    return (uint16_t)ms;
+}
+
 static void door_stop(void)
 {
     door_hw_stop();
+
+    if (g_motor_on) {
+        uint32_t on_ms = (uint32_t)(uptime_millis() - g_motor_on_ms);
+
+        energy_door_motor(on_ms);
+        g_pos_ms = pos_advance(g_pos_ms, on_ms);
+        g_motor_on = false;
+    }
+}
+
+static void door_drive(void)
+{
+    /* Door position is no longer known across a reset */
+    warm_state_invalidate();
+
+    door_hw_enable();
+
+    g_motor_on    = true;
+    g_motor_on_ms = uptime_millis();
 }
 
 static inline uint16_t door_settle_ms(void)
@@ -91,109 +197,119 @@ static inline uint16_t door_settle_ms(void)
 
 void door_sm_init(void)
 {
+    task_stop(&g_seq);
+
     door_lock_init();
     door_stop();
 
     g_settled_state = DEV_STATE_UNKNOWN;
-    g_motion_t0_ms  = 0;
+    g_pos_known     = false;
 
     set_motion(DOOR_IDLE_UNKNOWN);
 }
 
+void door_sm_restore(dev_state_t state)
+{
+    if (state == DEV_STATE_ON) {
+        g_settled_state = DEV_STATE_ON;
+        pos_settle(true);
+        set_motion(DOOR_IDLE_OPEN);
+    } else if (state == DEV_STATE_OFF) {
+        g_settled_state = DEV_STATE_OFF;
+        pos_settle(false);
+        set_motion(DOOR_IDLE_CLOSED);
+    }
+}
+
 void door_sm_request(dev_state_t state)
 {
     if (state != DEV_STATE_ON && state != DEV_STATE_OFF)
         return;
 
-    /* Abort any active motion immediately */
+    /* Abort any active motion or lock pulse immediately
+       (updates the estimate; lock position becomes UNKNOWN) */
     door_stop();
+    door_lock_stop();
 
-    g_motion_t0_ms  = 0;
     g_settled_state = DEV_STATE_UNKNOWN;
+    g_target        = state;
+    g_reverse       = false;
 
-    /* ALWAYS unlock first (blocking, safe) */
-    door_lock_release();
-
-    if (state == DEV_STATE_ON) {
-        /* OPEN */
-         door_hw_set_open_dir();
-        door_hw_enable();
-        set_motion(DOOR_MOVING_OPEN);
-    } else {
-        /* CLOSE */
-        door_hw_set_close_dir();
-        door_hw_enable();
-        set_motion(DOOR_MOVING_CLOSE);
-    }
+    /* Runs up to the first wait: unlocking or driving on return */
+    task_start(&g_seq, door_sequence);
 }
 
-void door_sm_tick(uint32_t now_ms)
+/*
+ * The whole motion, start to settled. Runs from timer_run() in
+ * main context; lock pulses are split (door_lock.h), so the loop
+ * keeps running while the lock is driven and settles.
+ */
+static task_status_t door_sequence(struct task *t)
 {
-    switch (g_motion) {
+    TASK_BEGIN(t);
 
-    /* --------------------------------------------------
-     * Door moving open
-     * -------------------------------------------------- */
-    case DOOR_MOVING_OPEN:
-        if (g_motion_t0_ms == 0) {
-            g_motion_t0_ms = now_ms;
-            break;
-        }
+    /* Report intent from the start (unlock and dead-time included) */
+    set_motion(g_target == DEV_STATE_ON ? DOOR_MOVING_OPEN
+                                        : DOOR_MOVING_CLOSE);
 
-        if ((uint32_t)(now_ms - g_motion_t0_ms) >= g_cfg.door_travel_ms) {
-            door_stop();
-            g_motion_t0_ms  = 0;
-            g_settled_state = DEV_STATE_ON;
-            set_motion(DOOR_IDLE_OPEN);
-        }
-        break;
+    /* Reversal: electrical dead-time before re-driving the bridge */
+    if (g_reverse)
+        TASK_AWAIT_MS(t, DOOR_REVERSAL_DELAY_MS);
 
-    /* --------------------------------------------------
-     * Door moving closed
-     * -------------------------------------------------- */
-    case DOOR_MOVING_CLOSE:
-        if (g_motion_t0_ms == 0) {
-            g_motion_t0_ms = now_ms;
-            break;
-        }
+    /* Unlock first; skipped if already unlocked */
+    g_lock_ms = door_lock_pulse_start(LOCK_STATE_UNLOCKED);
+
+    if (g_lock_ms) {
+        TASK_AWAIT_MS(t, g_lock_ms);
+        door_lock_pulse_finish(LOCK_STATE_UNLOCKED);
+
+        TASK_AWAIT_MS(t, door_lock_settle_ms());
+    }
+
+    /* Remaining distance only, when the position is known */
+    g_drive_ms = drive_time_ms(g_target == DEV_STATE_ON);
+
+    if (g_target == DEV_STATE_ON)
+        door_hw_set_open_dir();
+    else
+        door_hw_set_close_dir();
+
+    door_drive();
 
-        if ((uint32_t)(now_ms - g_motion_t0_ms) >= g_cfg.door_travel_ms) {
-            door_stop();
-            g_motion_t0_ms = now_ms;
-            set_motion(DOOR_POSTCLOSE_LOCK);
+    TASK_AWAIT_MS(t, g_drive_ms);
+
+    door_stop();
+
+    if (g_target == DEV_STATE_ON) {
+        pos_settle(true);
+        g_settled_state = DEV_STATE_ON;
+        set_motion(DOOR_IDLE_OPEN);
+    } else {
+        /* Closed: let it settle, then lock */
+        pos_settle(false);
+        set_motion(DOOR_POSTCLOSE_LOCK);
+
+        TASK_AWAIT_MS(t, door_settle_ms());
+
+        /*
+         * Lock pulse:
+         * - bounded by lock driver (hardware cut-off)
+         * - a new request aborts it with power OFF
+         */
+        g_lock_ms = door_lock_pulse_start(LOCK_STATE_LOCKED);
+
+        if (g_lock_ms) {
+            TASK_AWAIT_MS(t, g_lock_ms);
+            door_lock_pulse_finish(LOCK_STATE_LOCKED);
         }
-        break;
 
-    /* --------------------------------------------------
-     * Post-close delay + lock (blocking)
-     * -------------------------------------------------- */
-     case DOOR_POSTCLOSE_LOCK:
-         if ((uint32_t)(now_ms - g_motion_t0_ms) < door_settle_ms())
-             break;
-
-         /*
-          * Blocking lock pulse:
-          * - bounded by lock driver
-          * - returns with power OFF
-          * - nothing else should happen during this window
-          */
-         door_lock_engage();
-
-         g_motion_t0_ms  = 0;
-         g_settled_state = DEV_STATE_OFF;
-         set_motion(DOOR_IDLE_CLOSED);
-         break;
-
-    /* --------------------------------------------------
-     * Idle / unknown
-     * -------------------------------------------------- */
-    case DOOR_IDLE_OPEN:
-    case DOOR_IDLE_CLOSED:
-    case DOOR_IDLE_UNKNOWN:
-    default:
-        break;
+        g_settled_state = DEV_STATE_OFF;
+        set_motion(DOOR_IDLE_CLOSED);
     }
+
+    TASK_END(t);
 }
+
 dev_state_t door_sm_get_state(void)
 {
     switch (g_motion) {
@@ -226,6 +342,23 @@ door_motion_t door_sm_get_motion(void)
     return g_motion;
 }
 
+bool door_sm_get_position(uint16_t *pos_ms)
+{
+    if (!g_pos_known)
+        return false;
+
+    uint16_t pos = g_pos_ms;
+
+    /* Include the drive in progress */
+    if (g_motor_on)
+        pos = pos_advance(pos, (uint32_t)(uptime_millis() - g_motor_on_ms));
+
+    if (pos_ms)
+        *pos_ms = pos;
+
+    return true;
+}
+
 /*
  * door_sm_toggle()
  *
@@ -245,16 +378,20 @@ door_motion_t door_sm_get_motion(void)
  *   - Motion is always stopped before reversing direction.
  *   - A short electrical dead-time is inserted before re-driving
  *     the motor to prevent H-bridge shoot-through or current slam.
- *   - Lock release is handled inside door_sm_request().
- *   - Motion timers are reset before issuing the new request.
+ *   - Lock release is handled by the motion sequence (an unlock
+ *     pulse in progress is cut and re-driven).
+ *   - The dead-time is a wait in the motion sequence, not a
+ *     busy loop: the motion state reports the new direction
+ *     at once, the motor starts after the dead-time.
  *
  * Design Notes:
- *   - No partial-travel math is performed.
+ *   - The reversal drives only the estimated distance already
+ *     travelled, plus margin (see drive_time_ms()).
  *   - Internal actuator limit switches provide end-of-travel protection.
  *   - State machine remains the single authority for motion control.
  *
  * This function does NOT directly manipulate hardware direction pins.
- * It delegates all drive sequencing to door_sm_request().
+ * It delegates all drive sequencing to door_sequence().
  */
 
 void door_sm_toggle(void)
@@ -296,66 +433,59 @@ void door_sm_toggle(void)
 
     /* --- HARD STOP --- */
     door_stop();
+    door_lock_stop();
 
-    /* Reset timing */
-    g_motion_t0_ms  = 0;
     g_settled_state = DEV_STATE_UNKNOWN;
+    g_target        = target;
+    g_reverse       = true;
 
-    /* Electrical dead-time */
-    {
-        uint32_t t0 = uptime_millis();
-        while ((uint32_t)(uptime_millis() - t0) < DOOR_REVERSAL_DELAY_MS) {
-            /* allow other ticks */
-        }
-    }
-
-    /* Now issue clean request */
-    door_sm_request(target);
+    /* Restart the sequence; it drives after the dead-time */
+    task_start(&g_seq, door_sequence);
 }
 
-const char *door_sm_state_string(void)
+flash_str door_sm_state_string(void)
 {
     switch (g_settled_state) {
 
     case DEV_STATE_ON:
-        return "OPEN";
+        return FSTR("OPEN");
 
     case DEV_STATE_OFF:
-        return "CLOSED";
+        return FSTR("CLOSED");
 
     case DEV_STATE_UNKNOWN:
     default:
-        return "UNKNOWN";
+        return FS(UNKNOWN);
     }
 }
 
-const char *door_sm_motion_string(void)
+flash_str door_sm_motion_string(void)
 {
     switch (g_motion) {
 
     case DOOR_IDLE_OPEN:
-        return "IDLE_OPEN";
+        return FSTR("IDLE_OPEN");
 
     case DOOR_IDLE_CLOSED:
-        return "IDLE_CLOSED";
+        return FSTR("IDLE_CLOSED");
 
     case DOOR_MOVING_OPEN:
-        return "MOVING_OPEN";
+        return FSTR("MOVING_OPEN");
 
     case DOOR_MOVING_CLOSE:
-        return "MOVING_CLOSE";
+        return FSTR("MOVING_CLOSE");
 
     case DOOR_PREOPEN_UNLOCK:
-        return "PREOPEN_UNLOCK";
+        return FSTR("PREOPEN_UNLOCK");
 
     case DOOR_PRECLOSE_UNLOCK:
-        return "PRECLOSE_UNLOCK";
+        return FSTR("PRECLOSE_UNLOCK");
 
     case DOOR_POSTCLOSE_LOCK:
-        return "POSTCLOSE_LOCK";
+        return FSTR("POSTCLOSE_LOCK");
 
     case DOOR_IDLE_UNKNOWN:
     default:
-        return "UNKNOWN";
+        return FS(UNKNOWN);
     }
 }
@@ -9,6 +9,8 @@
  *  - Enforce time-based motion (no sensors)
  *  - Coordinate lock sequencing safely
  *  - Abort-and-restart on new command
+ *  - Estimate position from motor on-time, so a reversal or
+ *    re-command drives only the remaining distance (+ margin)
  *
  * Invariants:
  *  - Door ALWAYS unlocks before motion
@@ -17,7 +19,9 @@
  *  - OPEN is the safe default
  *
  * Notes:
- *  - Non-blocking, tick-driven state machine
+ *  - Non-blocking: each motion, lock pulses included, is one
+ *    linear task (task.h), resumed from timer_run() in the
+ *    main loop
  *  - dev_state_t expresses external intent only
  *  - Internal motion states represent physical truth
  */
@@ -25,7 +29,9 @@
 #pragma once
 
 #include <stdint.h>
+#include <stdbool.h>
 #include "device.h"   /* dev_state_t */
+#include "flash_str.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -65,6 +71,15 @@ typedef enum {
  */
 void door_sm_init(void);
 
+/*
+ * Adopt a settled state after a warm reset.
+ *
+ * - Does not move hardware (door and lock are where they were)
+ * - DEV_STATE_ON → IDLE_OPEN, DEV_STATE_OFF → IDLE_CLOSED (locked)
+ * - Anything else leaves the state UNKNOWN
+ */
+void door_sm_restore(dev_state_t state);
+
 /*
  * Request a new door state.
  *
@@ -80,16 +95,6 @@ void door_sm_init(void);
  */
 void door_sm_request(dev_state_t state);
 
-/*
- * Periodic service function.
- *
- * Parameters:
- *  - now_ms: current system time in milliseconds
- *
- * Must be called regularly to advance sequencing and timing.
- */
-void door_sm_tick(uint32_t now_ms);
-
 /*
  * Query the settled, device-visible door state.
  *
@@ -112,6 +117,17 @@ dev_state_t door_sm_get_state(void);
  */
 door_motion_t door_sm_get_motion(void);
 
+/*
+ * Estimated door position.
+ *
+ * pos_ms: open-direction travel time from CLOSED
+ *         (0 = closed, door_travel_ms = open)
+ *
+ * Returns false while the position is unknown (boot without a
+ * settled state, or partial motion from an unknown position).
+ */
+bool door_sm_get_position(uint16_t *pos_ms);
+
 
  /*
   * door_sm_toggle()
@@ -140,7 +156,7 @@ door_motion_t door_sm_get_motion(void);
  * Returns:
  *   "OPEN", "CLOSED", or "UNKNOWN"
  */
-const char *door_sm_state_string(void);
+flash_str door_sm_state_string(void);
 
 /*
  * Human-readable motion state string.
@@ -156,7 +172,7 @@ const char *door_sm_state_string(void);
  *     PRECLOSE_UNLOCK
  *     UNKNOWN
  */
-const char *door_sm_motion_string(void);
+flash_str door_sm_motion_string(void);
 
 #ifdef __cplusplus
 }
@@ -4,7 +4,11 @@
  * Project: Chicken Coop Controller
  * Purpose: Simple ON/OFF relay device
  *
- * Updated: 2026-01-01
+ * Notes:
+ *  - Sample of a vtable-only device; register it in
+ *    device_registry.h as vtable_dev<DEVICE_ID_FOO, &foo_device>
+ *
+ * Updated: 2026-10-18
  */
 
 #include "device.h"
@@ -25,17 +29,17 @@ static void foo_set_state(dev_state_t state)
     foo_state = state;
 
     // if (state == DEV_STATE_ON)
-    //     mini_printf("[HOST] foo ON\n");
+    //     mini_printf(FSTR("[HOST] foo ON\n"));
     // else if (state == DEV_STATE_OFF)
-    //     mini_printf("[HOST] foo OFF\n");
+    //     mini_printf(FSTR("[HOST] foo OFF\n"));
 }
 
-static const char *foo_state_string(dev_state_t state)
+static flash_str foo_state_string(dev_state_t state)
 {
     switch (state) {
-    case DEV_STATE_ON:  return "ON";
-    case DEV_STATE_OFF: return "OFF";
-    default:            return "UNKNOWN";
+    case DEV_STATE_ON:  return FS(ON);
+    case DEV_STATE_OFF: return FS(OFF);
+    default:            return FS(UNKNOWN);
     }
 }
 
@@ -47,20 +51,24 @@ static void foo_device_init(void)
         return;
 
     // foo HW init
-    // mini_printf("[HOST] foo INIT\n");
+    // mini_printf(FSTR("[HOST] foo INIT\n"));
     foo_set_state(DEV_STATE_OFF);
     init = 1;
 }
 
 
 
+static const char foo_name[] PROGMEM = "foo";
+
 Device foo_device = {
-    .name = "foo",
+    .name = FSTR_ARR(foo_name),
     .deviceID     = DEVICE_ID_FOO,
     .init = foo_device_init,
     .get_state = foo_get_state,
     .set_state = foo_set_state,
     .state_string = foo_state_string,
     .tick = NULL,
-    .is_busy  = NULL
+    .next_deadline_ms = NULL,
+    .is_busy  = NULL,
+    .restore  = NULL
 };
@@ -4,49 +4,60 @@
  * Project: Chicken Coop Controller
  * Purpose: Simple ON/OFF relay device
  *
- * Updated: 2026-01-01
+ * Updated: 2026-10-18
  */
 
 #include "device.h"
+#include "device_registry.h"
 #include "console/mini_printf.h"
 #include "led_state_machine.h"
 
 
 
-static dev_state_t led_get_state(void)
+dev_state_t led_dev::get_state(void)
 {
     return led_state_machine_is_on()? DEV_STATE_ON: DEV_STATE_OFF;
 }
 
 
-static const char *led_state_string(dev_state_t state)
+static flash_str led_state_string(dev_state_t state)
 {
     switch (state) {
-    case DEV_STATE_ON:  return "ON";
-    case DEV_STATE_OFF: return "OFF";
-    default:            return "UNKNOWN";
+    case DEV_STATE_ON:  return FS(ON);
+    case DEV_STATE_OFF: return FS(OFF);
+    default:            return FS(UNKNOWN);
     }
 }
 
-static void led_init(void)
+void led_dev::init(void)
 {
     led_state_machine_init();
 }
 
 
-static void led_tick(uint32_t now_ms)
+void led_dev::tick(uint32_t now_ms)
 {
     led_state_machine_tick(now_ms);
 }
 
+bool led_dev::next_deadline_ms(uint32_t now_ms, uint32_t *deadline_ms)
+{
+    (void)now_ms;
+    return led_state_machine_next_deadline(deadline_ms);
+}
+
+
+static const char led_name[] PROGMEM = "led";
 
 Device led_device = {
-    .name       = "led",
+    .name       = FSTR_ARR(led_name),
     .deviceID     = DEVICE_ID_LED,
-    .init      = led_init,
-    .get_state = led_get_state,
+    .init      = led_dev::init,
+    .get_state = led_dev::get_state,
     .set_state  = NULL,
     .state_string = led_state_string,
-    .tick         =  led_tick,
-    .is_busy         = NULL
+    .tick         =  led_dev::tick,
+    .next_deadline_ms = led_dev::next_deadline_ms,
+    .is_busy         = NULL,
+    .restore         = NULL
 };
@@ -7,6 +7,8 @@
  * Notes:
  *  - Non-blocking at the state-machine level
  *  - Software PWM carrier is driven by repeated door_led_tick() calls
+ *  - Full-brightness output is static (no carrier); tick() is only
+ *    due while a partial duty or the pulse envelope runs
  *  - Pulse envelope is rate-limited for smooth breathing
  *
  * Extended:
@@ -17,6 +19,10 @@
 
 #include "led_state_machine.h"
 #include "door_led.h"
+#include "metrics.h"
+#include "clock.h"
+#include "timer.h"
+#include "uptime.h"
 
 #include <stdint.h>
 #include <stdbool.h>
@@ -40,7 +46,7 @@ static led_color_t g_color = LED_GREEN;
 static uint16_t g_cycles_remaining = 0;   /* 0 = infinite */
 static uint16_t g_cycle_counter    = 0;   /* counts completed cycles */
 
-static uint32_t g_blink_t0_ms = 0;
+static struct soft_timer g_blink_timer;
 static bool     g_led_on      = false;
 
 /* Pulse timing (in PWM ticks) */
@@ -49,6 +55,9 @@ static uint8_t  g_pulse_step       = 0;
 static uint32_t g_pwm_ticks        = 0;
 static uint32_t g_pulse_err        = 0;
 
+/* Last carrier service (ms) */
+static uint32_t g_pwm_last_ms      = 0;
+
 /* --------------------------------------------------------------------------
  * Perceptual breathing envelopes
  * -------------------------------------------------------------------------- */
@@ -93,24 +102,52 @@ static inline void led_apply(bool on, uint8_t duty)
 
 static void door_led_pwm_service(uint32_t now_ms)
 {
-    static uint32_t last_ms = 0;
-
-    uint32_t elapsed = now_ms - last_ms;
+    uint32_t elapsed = now_ms - g_pwm_last_ms;
     if (elapsed == 0)
         return;
 
-    last_ms = now_ms;
+    g_pwm_last_ms = now_ms;
 
-    uint32_t ticks = elapsed * PWM_TICKS_PER_MS;
+    /*
+     * On the slow clock, fewer coarser ticks cover the same time:
+     * carrier frequency and g_pwm_ticks (fast-tick units) are kept.
+     */
+    const uint8_t shift = clock_shift();
+    const uint8_t step  = (uint8_t)(1u << shift);
 
-    const uint32_t MAX_TICKS = 10u * PWM_TICKS_PER_MS;
+    uint32_t ticks = elapsed * (PWM_TICKS_PER_MS >> shift);
+
+    const uint32_t MAX_TICKS = 10u * (PWM_TICKS_PER_MS >> shift);
     if (ticks > MAX_TICKS)
         ticks = MAX_TICKS;
 
     while (ticks--) {
-        door_led_tick();
-        g_pwm_ticks++;
+        door_led_tick(step);
+        g_pwm_ticks += step;
+    }
+}
+
+/* Blink phase timer (periodic, BLINK_PERIOD_MS) */
+static void led_blink_expired(uint32_t now_ms)
+{
+    (void)now_ms;
+
+    g_led_on = !g_led_on;
+
+    /* Count full cycle on falling edge (ON->OFF) */
+    if (!g_led_on && g_cycles_remaining > 0) {
+
+        g_cycle_counter++;
+
+        if (g_cycle_counter >= g_cycles_remaining) {
+            timer_stop(&g_blink_timer);
+            g_mode = LED_OFF;
+            door_led_off();
+            return;
+        }
     }
+
+    led_apply(g_led_on, 255);
 }
 
 /* --------------------------------------------------------------------------
@@ -127,7 +164,7 @@ void led_state_machine_init(void)
     g_cycles_remaining  = 0;
     g_cycle_counter     = 0;
 
-    g_blink_t0_ms       = 0;
+    timer_stop(&g_blink_timer);
     g_led_on            = false;
 
     g_pulse_last_ticks  = 0;
@@ -151,12 +188,15 @@ void led_state_machine_init(void)
                             led_color_t color,
                             uint16_t count)
  {
+     if (mode != g_mode)
+         metric_inc(METRIC_LED_MODE);
+
      g_mode             = mode;
      g_color            = color;
      g_cycles_remaining = count;
      g_cycle_counter    = 0;
 
-     g_blink_t0_ms      = 0;
+     timer_stop(&g_blink_timer);
      g_led_on           = false;
 
      g_pulse_last_ticks = 0;
@@ -168,6 +208,12 @@ void led_state_machine_init(void)
          return;
      }
 
+     if (mode == LED_BLINK) {
+         timer_start(&g_blink_timer, led_blink_expired, uptime_millis(),
+                     BLINK_PERIOD_MS, BLINK_PERIOD_MS);
+         return;
+     }
+
      if (mode == LED_ON) {
          g_led_on = true;
          led_apply(true, 255);
@@ -200,6 +246,15 @@ void led_state_machine_set(led_mode_t mode,
     led_state_machine_set(mode, color, 0);
 }
 
+bool led_state_machine_next_deadline(uint32_t *deadline_ms)
+{
+    if (g_mode != LED_PULSE && !door_led_needs_tick())
+        return false;
+
+    *deadline_ms = g_pwm_last_ms + 1u;
+    return true;
+}
+
 bool led_state_machine_is_on(void)
 {
     return g_led_on;
@@ -227,28 +282,7 @@ void led_state_machine_tick(uint32_t now_ms)
         break;
 
     case LED_BLINK:
-
-        if (g_blink_t0_ms == 0)
-            g_blink_t0_ms = now_ms;
-
-        if ((uint32_t)(now_ms - g_blink_t0_ms) >= BLINK_PERIOD_MS) {
-
-            g_led_on = !g_led_on;
-            g_blink_t0_ms = now_ms;
-
-            /* Count full cycle on falling edge (ON->OFF) */
-            if (!g_led_on && g_cycles_remaining > 0) {
-
-                g_cycle_counter++;
-
-                if (g_cycle_counter >= g_cycles_remaining) {
-                    g_mode = LED_OFF;
-                    door_led_off();
-                    return;
-                }
-            }
-        }
-
+        /* Phase flips in led_blink_expired() */
         led_apply(g_led_on, 255);
         break;
 
@@ -19,7 +19,7 @@
  *  - Platform-agnostic
  *  - All timing handled internally
  *  - Hardware access via door_led_* functions
- *  - Must be serviced periodically via tick()
+ *  - Serviced via tick() while next_deadline() reports work
  */
 
 /* LED presentation modes */
@@ -66,6 +66,17 @@ void led_state_machine_set(led_mode_t mode,
  */
 void led_state_machine_tick(uint32_t now_ms);
 
+/*
+ * Next time tick() has work (absolute uptime ms).
+ *
+ * Returns:
+ *  - true  while the software PWM carrier or the pulse envelope
+ *          runs (due every ms)
+ *  - false when the output is static (off, solid on, blink phases;
+ *          blink runs on a soft timer)
+ */
+bool led_state_machine_next_deadline(uint32_t *deadline_ms);
+
 /*
  * Coarse query: is LED currently driven on?
  *
@@ -4,22 +4,23 @@
  * Project: Chicken Coop Controller
  * Purpose: Simple ON/OFF relay device
  *
- * Updated: 2026-01-01
+ * Updated: 2026-10-18
  */
 
 #include "device.h"
+#include "device_registry.h"
 #include "relay_hw.h"
 
 static dev_state_t relay1_state = DEV_STATE_UNKNOWN;
 static dev_state_t relay2_state = DEV_STATE_UNKNOWN;
 
 
-static dev_state_t relay1_get_state(void)
+dev_state_t relay1_dev::get_state(void)
 {
     return relay1_state;
 }
 
-static void relay1_set_state(dev_state_t state)
+void relay1_dev::set_state(dev_state_t state)
 {
     if (state == relay1_state)
         return;
@@ -32,12 +33,12 @@ static void relay1_set_state(dev_state_t state)
         relay1_reset();
 }
 
-static dev_state_t relay2_get_state(void)
+dev_state_t relay2_dev::get_state(void)
 {
     return relay2_state;
 }
 
-static void relay2_set_state(dev_state_t state)
+void relay2_dev::set_state(dev_state_t state)
 {
     if (state == relay2_state)
         return;
@@ -50,46 +51,77 @@ static void relay2_set_state(dev_state_t state)
         relay2_reset();
 }
 
-static const char *relay_state_string(dev_state_t state)
+static flash_str relay_state_string(dev_state_t state)
 {
     switch (state) {
-    case DEV_STATE_ON:  return "ON";
-    case DEV_STATE_OFF: return "OFF";
-    default:            return "UNKNOWN";
+    case DEV_STATE_ON:  return FS(ON);
+    case DEV_STATE_OFF: return FS(OFF);
+    default:            return FS(UNKNOWN);
     }
 }
 
 
-static void relay_device_init(void)
+static void relay_hw_once(void)
 {
     static uint8_t init = 0;
     if (init)
         return;
 
     relay_init();
-    relay1_set_state(DEV_STATE_OFF);
-    relay2_set_state(DEV_STATE_OFF);
     init = 1;
 }
 
+void relay1_dev::init(void)
+{
+    relay_hw_once();
+    relay1_dev::set_state(DEV_STATE_OFF);
+}
+
+void relay2_dev::init(void)
+{
+    relay_hw_once();
+    relay2_dev::set_state(DEV_STATE_OFF);
+}
+
+/* Latching relays hold their contacts across a reset: no pulse */
+void relay1_dev::restore(dev_state_t state)
+{
+    relay_hw_once();
+    relay1_state = state;
+}
+
+void relay2_dev::restore(dev_state_t state)
+{
+    relay_hw_once();
+    relay2_state = state;
+}
+
+static const char relay1_name[] PROGMEM = "relay1";
+
 Device relay1_device = {
-    .name = "relay1",
+    .name = FSTR_ARR(relay1_name),
     .deviceID     = DEVICE_ID_RELAY1,
-    .init = relay_device_init,
-    .get_state = relay1_get_state,
-    .set_state = relay1_set_state,
+    .init = relay1_dev::init,
+    .get_state = relay1_dev::get_state,
+    .set_state = relay1_dev::set_state,
     .state_string = relay_state_string,
     .tick = NULL,
-    .is_busy  = NULL
+    .next_deadline_ms = NULL,
+    .is_busy  = NULL,
+    .restore = relay1_dev::restore
 };
 
+static const char relay2_name[] PROGMEM = "relay2";
+
 Device relay2_device = {
-    .name = "relay2",
+    .name = FSTR_ARR(relay2_name),
     .deviceID     = DEVICE_ID_RELAY2,
-     .init = relay_device_init,
-    .get_state = relay2_get_state,
-    .set_state = relay2_set_state,
+    .init = relay2_dev::init,
+    .get_state = relay2_dev::get_state,
+    .set_state = relay2_dev::set_state,
     .state_string = relay_state_string,
     .tick = NULL,
-    .is_busy  = NULL
+    .next_deadline_ms = NULL,
+    .is_busy  = NULL,
+    .restore = relay2_dev::restore
 };
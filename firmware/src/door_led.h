@@ -42,6 +42,7 @@ void door_led_off(void);
  * Behavior:
  *  - Enables PWM on GREEN channel only
  *  - Forces RED channel inactive
+ *  - 255 drives the channel solid (no ticks needed)
  *  - Does not block or delay
  */
 void door_led_green_pwm(uint8_t duty);
@@ -55,13 +56,26 @@ void door_led_green_pwm(uint8_t duty);
  * Behavior:
  *  - Enables PWM on RED channel only
  *  - Forces GREEN channel inactive
+ *  - 255 drives the channel solid (no ticks needed)
  *  - Does not block or delay
  */
 void door_led_red_pwm(uint8_t duty);
 
 
+/*
+ * Does the carrier need door_led_tick()?
+ *
+ * Full duty (255) drives the pin solid and needs no ticks; only a
+ * partial duty (1..254) does.
+ */
+bool door_led_needs_tick(void);
+
 /* --------------------------------------------------------------------------
  * PWM tick (call at fixed rate, e.g. 1 kHz)
+ *
+ * step: phase advance per call (1 = full 8-bit resolution).
+ * A larger step keeps the carrier frequency with fewer calls,
+ * e.g. on a scaled-down CPU clock.
  * -------------------------------------------------------------------------- */
 
-void door_led_tick(void);
+void door_led_tick(uint8_t step);
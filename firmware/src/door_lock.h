@@ -16,36 +16,79 @@ extern "C" {
  * lock motor / solenoid) via an H-bridge.
  *
  * Key properties:
- *  - BLOCKING by design
+ *  - BLOCKING by design (engage / release); the door sequence
+ *    uses the split pulse below instead, so the main loop keeps
+ *    running while the lock is driven
  *  - Enforced maximum on-time (hardware safety)
- *  - No background state
+ *  - Only state kept: the last completed drive direction
  *  - No dependence on main loop timing
  *
  * SAFETY CONTRACT
  * ---------------
- * If any function in this module returns, the lock output is OFF.
- * There is no scenario where the actuator can remain powered
- * due to scheduler failure, missed ticks, or logic bugs upstream.
+ * If any blocking function in this module returns, the lock output
+ * is OFF. A split pulse is cut by a timer compare interrupt at its
+ * on-time, whether or not the caller comes back. There is no
+ * scenario where the actuator can remain powered due to scheduler
+ * failure, missed ticks, or logic bugs upstream.
  *
  * The caller is allowed to stall while the lock is energized.
  * This is intentional and required for safety.
  */
 
+/*
+ * Believed lock position.
+ *
+ * Set only by a completed pulse (or a restore at boot).
+ * UNKNOWN after init and while a pulse is in progress.
+ */
+typedef enum {
+    LOCK_STATE_UNKNOWN = 0,
+    LOCK_STATE_LOCKED,
+    LOCK_STATE_UNLOCKED
+} door_lock_state_t;
+
 /* Initialize lock GPIO and force safe OFF state (idempotent) */
 void door_lock_init(void);
 
 /*
  * Engage the lock (blocking pulse).
  * Direction is fixed and enforced internally.
+ * No pulse if the lock is already believed LOCKED.
  */
 void door_lock_engage(void);
 
 /*
- * Release the lock (blocking pulse).
+ * Release the lock (blocking pulse + settle).
  * Direction is fixed and enforced internally.
+ * No pulse if the lock is already believed UNLOCKED.
  */
 void door_lock_release(void);
 
+/* Pulse regardless of the believed state (manual override) */
+void door_lock_engage_force(void);
+void door_lock_release_force(void);
+
+/*
+ * Split (non-blocking) pulse toward target (LOCKED / UNLOCKED).
+ *
+ * door_lock_pulse_start() powers the lock and returns its on-time
+ * in ms; 0 if the lock is already believed at target (no pulse).
+ * Power is cut in interrupt context at the on-time. After that,
+ * door_lock_pulse_finish() records target. A release then needs
+ * door_lock_settle_ms() before the door moves.
+ *
+ * door_lock_stop() abandons a pulse (position stays UNKNOWN).
+ */
+uint16_t door_lock_pulse_start(door_lock_state_t target);
+void     door_lock_pulse_finish(door_lock_state_t target);
+uint16_t door_lock_settle_ms(void);
+
+/* Current believed position */
+door_lock_state_t door_lock_get_state(void);
+
+/* Seed the believed position at boot (warm RAM / EEPROM) */
+void door_lock_restore(door_lock_state_t state);
+
 /*
  * Immediately disable lock output.
  * Safe to call at any time.
@@ -0,0 +1,52 @@
+/*
+ * ee_async.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Deferred (non-blocking) EEPROM byte writer
+ *
+ * Notes:
+ *  - An EEPROM byte write takes ~3.3 ms on the ATmega1284P
+ *  - Callers queue bytes here and return immediately
+ *  - The main loop drains the queue one byte per EEPROM-ready window
+ *  - Fixed-size RAM queue, no dynamic allocation
+ *  - The system must not power down while bytes are pending
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/*
+ * Queue `len` bytes from RAM `src` for writing at EEPROM address `ee_dst`.
+ *
+ * Behavior:
+ *  - All-or-nothing: returns false (and queues nothing) if the
+ *    queue does not have room for the whole block
+ *  - Bytes are written in the order queued
+ *  - Unchanged bytes are skipped at write time (update semantics)
+ */
+bool ee_async_write(void *ee_dst, const void *src, uint8_t len);
+
+/*
+ * Periodic service function.
+ *
+ * Writes at most one byte, and only if the EEPROM is ready.
+ * Never blocks.
+ */
+void ee_async_service(void);
+
+/*
+ * Returns true while queued bytes have not yet been written,
+ * or the last byte is still programming.
+ */
+bool ee_async_busy(void);
+
+/*
+ * Block until every queued byte has been written.
+ *
+ * Console / cold paths only.
+ */
+void ee_async_flush(void);
@@ -0,0 +1,225 @@
+/*
+ * energy.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Per-day energy ledger and battery-life estimate
+ *
+ * Notes:
+ *  - Platform independent
+ *  - Hooks are counters only; all arithmetic happens on report
+ *  - Float is confined to the reporting path (console only)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "energy.h"
+#include "config.h"
+
+#include <string.h>
+
+#define SECONDS_PER_DAY  86400ul
+
+/* 1 uAh = 3.6e6 uA*ms = 3.6e6 nC */
+#define UA_MS_PER_UAH    3600000.0f
+
+/* --------------------------------------------------------------------------
+ * Internal state
+ * -------------------------------------------------------------------------- */
+
+static struct energy_day g_today;
+
+static struct energy_day g_hist[ENERGY_HISTORY_DAYS];
+static uint8_t g_hist_head  = 0;    /* next slot to fill */
+static uint8_t g_hist_count = 0;
+
+static bool          g_awake_open   = false;
+static energy_wake_t g_awake_reason = ENERGY_WAKE_OTHER;
+static uint32_t      g_awake_t0_ms  = 0;
+
+/* Charge of completed days since boot */
+static uint32_t g_consumed_uah = 0;
+
+/* --------------------------------------------------------------------------
+ * Awake accounting
+ * -------------------------------------------------------------------------- */
+
+void energy_wake_begin(energy_wake_t reason, uint32_t now_ms)
+{
+    if ((uint8_t)reason >= ENERGY_WAKE_COUNT)
+        reason = ENERGY_WAKE_OTHER;
+
+    energy_wake_end(now_ms);
+
+    g_awake_open   = true;
+    g_awake_reason = reason;
+    g_awake_t0_ms  = now_ms;
+
+    if (g_today.wakes[reason] != 0xFFFFu)
+        g_today.wakes[reason]++;
+}
+
+void energy_wake_end(uint32_t now_ms)
+{
+    if (!g_awake_open)
+        return;
+
+    g_today.awake_ms[g_awake_reason] += (uint32_t)(now_ms - g_awake_t0_ms);
+    g_awake_open = false;
+}
+
+void energy_checkpoint(uint32_t now_ms)
+{
+    if (!g_awake_open)
+        return;
+
+    g_today.awake_ms[g_awake_reason] += (uint32_t)(now_ms - g_awake_t0_ms);
+    g_awake_t0_ms = now_ms;
+}
+
+void energy_day_rollover(int y, int mo, int d,
+                         uint32_t sec_of_day,
+                         uint32_t now_ms)
+{
+    /* First known date: the running day started mid-day */
+    if (g_today.year == 0) {
+        g_today.year    = (uint16_t)y;
+        g_today.month   = (uint8_t)mo;
+        g_today.day     = (uint8_t)d;
+        g_today.start_s = sec_of_day;
+        return;
+    }
+
+    if (g_today.year  == (uint16_t)y &&
+        g_today.month == (uint8_t)mo &&
+        g_today.day   == (uint8_t)d)
+        return;
+
+    /* Split an open awake interval at the day boundary */
+    energy_checkpoint(now_ms);
+
+    g_consumed_uah += energy_day_uah(&g_today, SECONDS_PER_DAY);
+
+    g_hist[g_hist_head] = g_today;
+    g_hist_head = (uint8_t)((g_hist_head + 1u) % ENERGY_HISTORY_DAYS);
+    if (g_hist_count < ENERGY_HISTORY_DAYS)
+        g_hist_count++;
+
+    memset(&g_today, 0, sizeof(g_today));
+    g_today.year  = (uint16_t)y;
+    g_today.month = (uint8_t)mo;
+    g_today.day   = (uint8_t)d;
+}
+
+/* --------------------------------------------------------------------------
+ * Activity hooks
+ * -------------------------------------------------------------------------- */
+
+void energy_i2c_xfer(void)
+{
+    g_today.i2c_xfers++;
+}
+
+void energy_door_motor(uint32_t ms)
+{
+    g_today.door_motor_ms += ms;
+}
+
+void energy_lock_pulse(uint16_t ms)
+{
+    g_today.lock_ms += ms;
+}
+
+void energy_relay_pulse(uint16_t ms)
+{
+    if (g_today.relay_pulses != 0xFFFFu)
+        g_today.relay_pulses++;
+    g_today.relay_ms += ms;
+}
+
+/* --------------------------------------------------------------------------
+ * Reporting
+ * -------------------------------------------------------------------------- */
+
+const struct energy_day *energy_today(void)
+{
+    return &g_today;
+}
+
+const struct energy_day *energy_history(uint8_t back)
+{
+    if (back >= g_hist_count)
+        return NULL;
+
+    uint8_t slot = (uint8_t)((g_hist_head + ENERGY_HISTORY_DAYS - 1u - back)
+                             % ENERGY_HISTORY_DAYS);
+    return &g_hist[slot];
+}
+
+uint32_t energy_day_uah(const struct energy_day *d, uint32_t end_s)
+{
+    if (!d)
+        return 0;
+
+    uint32_t awake_ms = 0;
+    for (uint8_t i = 0; i < ENERGY_WAKE_COUNT; i++)
+        awake_ms += d->awake_ms[i];
+
+    /* Whatever was not awake was PWR_DOWN */
+    uint32_t span_ms = 0;
+    if (end_s > d->start_s)
+        span_ms = (end_s - d->start_s) * 1000ul;
+
+    uint32_t sleep_ms = (span_ms > awake_ms) ? (span_ms - awake_ms) : 0;
+
+    uint32_t run_ms = awake_ms - d->awake_ms[ENERGY_WAKE_CONFIG];
+
+    float ua_ms = 0.0f;
+
+    ua_ms += (float)g_cfg.sleep_ua   * (float)sleep_ms;
+    ua_ms += (float)g_cfg.awake_ua   * (float)run_ms;
+    ua_ms += (float)g_cfg.console_ua * (float)d->awake_ms[ENERGY_WAKE_CONFIG];
+
+    ua_ms += (float)g_cfg.door_motor_ma * 1000.0f * (float)d->door_motor_ms;
+    ua_ms += (float)g_cfg.lock_ma       * 1000.0f * (float)d->lock_ms;
+    ua_ms += (float)g_cfg.relay_ma      * 1000.0f * (float)d->relay_ms;
+
+    /* nC and uA*ms share the same scale */
+    ua_ms += (float)g_cfg.i2c_nc * (float)d->i2c_xfers;
+
+    return (uint32_t)(ua_ms / UA_MS_PER_UAH + 0.5f);
+}
+
+bool energy_estimate(uint32_t now_s,
+                     uint32_t *avg_uah,
+                     uint32_t *days_left)
+{
+    uint32_t sum  = 0;
+    uint8_t  full = 0;
+
+    for (uint8_t i = 0; i < g_hist_count; i++) {
+        const struct energy_day *d = energy_history(i);
+        if (d->start_s != 0)
+            continue;       /* partial (boot) day */
+
+        sum += energy_day_uah(d, SECONDS_PER_DAY);
+        full++;
+    }
+
+    if (full == 0)
+        return false;
+
+    uint32_t avg = sum / full;
+    if (avg == 0)
+        avg = 1;
+
+    uint32_t used = g_consumed_uah + energy_day_uah(&g_today, now_s);
+    uint32_t cap  = (uint32_t)g_cfg.batt_capacity_mah * 1000ul;
+
+    if (avg_uah)
+        *avg_uah = avg;
+
+    if (days_left)
+        *days_left = (cap > used) ? (cap - used) / avg : 0;
+
+    return true;
+}
@@ -0,0 +1,138 @@
+/*
+ * energy.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Per-day energy ledger and battery-life estimate
+ *
+ * Design:
+ *  - Accumulates raw activity per calendar day:
+ *      awake time by wake reason, I2C transactions,
+ *      door motor on-time, lock pulse time, relay coil pulses
+ *  - Charge is derived from the raw counters on demand,
+ *    using the current coefficients in g_cfg
+ *  - Completed days are kept in a small RAM history ring
+ *
+ * Notes:
+ *  - Awake time is measured with uptime_millis(), which does not
+ *    advance in PWR_DOWN: everything not awake is sleep
+ *  - Coefficients are battery-side currents (see config.h)
+ *  - RAM only; history is lost on reset
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Completed days retained */
+#define ENERGY_HISTORY_DAYS  7u
+
+/* Why the MCU is awake */
+typedef enum {
+    ENERGY_WAKE_RTC = 0,        /* RTC alarm (INT0) */
+    ENERGY_WAKE_BUTTON,         /* door button (INT1) */
+    ENERGY_WAKE_CONFIG,         /* CONFIG switch / console session */
+    ENERGY_WAKE_OTHER,          /* boot, spurious wake */
+    ENERGY_WAKE_COUNT
+} energy_wake_t;
+
+struct energy_day {
+    uint16_t year;              /* 0 = date not yet known */
+    uint8_t  month;
+    uint8_t  day;
+    uint32_t start_s;           /* second-of-day accounting began (0 = full day) */
+
+    uint32_t awake_ms[ENERGY_WAKE_COUNT];
+    uint16_t wakes[ENERGY_WAKE_COUNT];
+
+    uint32_t i2c_xfers;
+    uint32_t door_motor_ms;
+    uint32_t lock_ms;
+    uint16_t relay_pulses;
+    uint32_t relay_ms;
+};
+
+/* --------------------------------------------------------------------------
+ * Awake accounting
+ * -------------------------------------------------------------------------- */
+
+/*
+ * Start an awake interval attributed to `reason`.
+ * Any interval already open is closed first.
+ */
+void energy_wake_begin(energy_wake_t reason, uint32_t now_ms);
+
+/* Close the open awake interval (call just before sleeping) */
+void energy_wake_end(uint32_t now_ms);
+
+/*
+ * Bank the open awake interval so far, without counting a new wake.
+ * Used before reporting.
+ */
+void energy_checkpoint(uint32_t now_ms);
+
+/*
+ * Report the current local date.
+ *
+ * - First call dates the running (partial) day
+ * - A date change pushes the running day into history
+ *   and starts a new, full day
+ */
+void energy_day_rollover(int y, int mo, int d,
+                         uint32_t sec_of_day,
+                         uint32_t now_ms);
+
+/* --------------------------------------------------------------------------
+ * Activity hooks (called by drivers)
+ * -------------------------------------------------------------------------- */
+
+void energy_i2c_xfer(void);
+void energy_door_motor(uint32_t ms);
+void energy_lock_pulse(uint16_t ms);
+void energy_relay_pulse(uint16_t ms);
+
+/* --------------------------------------------------------------------------
+ * Reporting
+ * -------------------------------------------------------------------------- */
+
+/* Running day */
+const struct energy_day *energy_today(void);
+
+/*
+ * Completed day, counting back.
+ *
+ * Parameters:
+ *  back - 0 = yesterday
+ *
+ * Returns NULL if no such day is held.
+ */
+const struct energy_day *energy_history(uint8_t back);
+
+/*
+ * Estimated charge for a day, in uAh.
+ *
+ * Parameters:
+ *  end_s - second-of-day the day ran until (86400 for completed days)
+ */
+uint32_t energy_day_uah(const struct energy_day *d, uint32_t end_s);
+
+/*
+ * Battery projection.
+ *
+ * Parameters:
+ *  now_s - current second-of-day (charges the running day so far)
+ *
+ * Outputs:
+ *  avg_uah   - mean charge per completed full day
+ *  days_left - remaining capacity / avg_uah
+ *
+ * Notes:
+ *  - Consumption is counted from boot (battery assumed fresh at power-on)
+ *
+ * Returns false if no full day has been recorded yet.
+ */
+bool energy_estimate(uint32_t now_s,
+                     uint32_t *avg_uah,
+                     uint32_t *days_left);
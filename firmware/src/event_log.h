@@ -0,0 +1,101 @@
+/*
+ * event_log.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Persistent actuator audit log (EEPROM ring)
+ *
+ * Design:
+ *  - Append-only circular log of fixed-size records
+ *  - Each record: UTC epoch, device, action, source
+ *  - The ring itself is the wear leveling: every slot is written
+ *    once per wrap, never rewritten in place
+ *  - Appends are queued through ee_async and never block the
+ *    actuator path on EEPROM write cycles
+ *  - Boot finds the head with one bounded pass over the slot
+ *    sequence bytes (no index cell that would wear out)
+ *
+ * Notes:
+ *  - Records what was COMMANDED, and by whom
+ *  - Epoch comes from rtc_get_epoch() (0 if RTC not set)
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Number of records held before the oldest is overwritten */
+#define EVENT_LOG_SLOTS  128u
+
+/* What was done */
+typedef enum {
+    EVLOG_ACTION_OFF = 0,       /* device OFF / door CLOSE */
+    EVLOG_ACTION_ON,            /* device ON  / door OPEN  */
+    EVLOG_ACTION_LOCK,          /* lock engage (device = door) */
+    EVLOG_ACTION_UNLOCK         /* lock release (device = door) */
+} evlog_action_t;
+
+/* Who asked for it */
+typedef enum {
+    EVLOG_SRC_SCHEDULE = 0,
+    EVLOG_SRC_BUTTON,
+    EVLOG_SRC_CONSOLE
+} evlog_source_t;
+
+/*
+ * On-EEPROM record (8 bytes).
+ *
+ * seq cycles 0..254; 0xFF marks an erased slot. An append sets
+ * seq to 0xFF first, then writes the record with seq LAST, so a
+ * torn write leaves 0xFF in the slot: the chain breaks there, the
+ * slot is not counted and becomes the head again on the next boot.
+ */
+struct event_log_rec {
+    uint32_t epoch;
+    uint8_t  device_id;
+    uint8_t  action;            /* evlog_action_t */
+    uint8_t  source;            /* evlog_source_t */
+    uint8_t  seq;
+};
+
+/*
+ * Locate the log head.
+ *
+ * - Called once at boot
+ * - Reads one sequence byte per slot (bounded: EVENT_LOG_SLOTS)
+ */
+void event_log_init(void);
+
+/*
+ * Append a record stamped with rtc_get_epoch().
+ *
+ * Returns:
+ *  - true  if queued for writing
+ *  - false if the EEPROM write queue was full (record dropped)
+ */
+bool event_log_append(uint8_t device_id,
+                      evlog_action_t action,
+                      evlog_source_t source);
+
+/* Number of valid records currently held (0..EVENT_LOG_SLOTS) */
+uint16_t event_log_count(void);
+
+/* Number of records dropped because the write queue was full */
+uint16_t event_log_dropped(void);
+
+/*
+ * Read a record, counting back from the newest.
+ *
+ * Parameters:
+ *  back - 0 = newest, count-1 = oldest
+ *
+ * Notes:
+ *  - Flushes pending writes first (console / cold path only)
+ *
+ * Returns:
+ *  - true  if record exists
+ *  - false if back >= count
+ */
+bool event_log_read(uint16_t back, struct event_log_rec *out);
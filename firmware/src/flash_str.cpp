@@ -0,0 +1,14 @@
+/*
+ * flash_str.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Interned flash strings (FLASH_STRING_LIST storage)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "flash_str.h"
+
+#define FLASH_STRING_DEF(id, text) const char fs_##id[] PROGMEM = text;
+FLASH_STRING_LIST(FLASH_STRING_DEF)
+#undef FLASH_STRING_DEF
@@ -0,0 +1,66 @@
+/*
+ * flash_str.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Flash (PROGMEM) string type
+ *
+ * Design:
+ *  - flash_str is a pointer to an opaque type, NOT const char *:
+ *    a flash address can never reach strcmp() / console_puts(RAM)
+ *    by accident, and overloads pick the flash reader
+ *  - FSTR("...") places a literal in flash at the call site
+ *    (function scope only, like PSTR)
+ *  - Literals used in more than one place are interned once in
+ *    FLASH_STRING_LIST and referenced with FS(id)
+ *  - Static tables name a PROGMEM array with FSTR_ARR(arr)
+ *
+ * Notes:
+ *  - Consumers: console_puts(), mini_printf() (format and %S),
+ *    cfmt() (%s), device names and state strings
+ *  - 'make str-report' shows literal bytes still copied to SRAM
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <avr/pgmspace.h>
+
+struct flash_char;                      /* never defined */
+typedef const flash_char *flash_str;
+
+#define FSTR(s)         (reinterpret_cast<flash_str>(PSTR(s)))
+#define FSTR_ARR(a)     (reinterpret_cast<flash_str>(a))
+
+/* Raw flash address, for the avr-libc _P functions */
+static inline const char *flash_ptr(flash_str s)
+{
+    return reinterpret_cast<const char *>(s);
+}
+
+/*
+ * Interned literals (stored once, shared by every user)
+ * id, text
+ */
+#define FLASH_STRING_LIST(X)                                \
+    X(ERROR,           "ERROR\n")                   \
+    X(OK,              "OK\n")                      \
+    X(WHAT,            "?\n")                       \
+    X(TIME_NOT_SET,    "TIME: NOT SET\n")           \
+    X(NO_EVENTS,       "(no events)\n")             \
+    X(RTC_SET_FAILED,  "ERROR: RTC SET FAILED\n")   \
+    X(ERROR_STATE,     "ERROR STATE\n")             \
+    X(BANNER,          "Chicken Coop Controller ")  \
+    X(SOLAR_ACTUAL,    "Actual     ")               \
+    X(SOLAR_CIVIL,     "Civil      ")               \
+    X(GAP4,            "    ")                      \
+    X(QMARK,           "?")                         \
+    X(ON,              "ON")                        \
+    X(OFF,             "OFF")                       \
+    X(UNKNOWN,         "UNKNOWN")
+
+#define FLASH_STRING_DECL(id, text) extern const char fs_##id[] PROGMEM;
+FLASH_STRING_LIST(FLASH_STRING_DECL)
+#undef FLASH_STRING_DECL
+
+#define FS(id)          FSTR_ARR(fs_##id)
@@ -0,0 +1,213 @@
+/*
+ * input.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Debounced inputs and button gestures (see input.h)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "input.h"
+#include "timer.h"
+
+#include <avr/pgmspace.h>
+
+/* --------------------------------------------------------------------------
+ * Configuration
+ * -------------------------------------------------------------------------- */
+
+#define DOOR_DEBOUNCE_MS    20u
+#define CONFIG_DEBOUNCE_MS  75u
+
+struct input_cfg {
+    uint8_t samples;        /* debounce window, in samples */
+    uint8_t gestures;       /* momentary with gestures, else level */
+};
+
+static const struct input_cfg input_cfg[INPUT_COUNT] PROGMEM = {
+    { DOOR_DEBOUNCE_MS   / INPUT_SAMPLE_MS, 1 },
+    { CONFIG_DEBOUNCE_MS / INPUT_SAMPLE_MS, 0 },
+};
+
+/* --------------------------------------------------------------------------
+ * State
+ * -------------------------------------------------------------------------- */
+
+struct input_state {
+    bool     level;         /* debounced */
+    bool     settling;      /* edge seen, level not confirmed yet */
+    uint8_t  count;         /* consecutive samples != level */
+    bool     long_fired;    /* LONG sent for this press */
+    bool     tap;           /* one press released, double window open */
+    uint32_t t0_ms;         /* press accepted / tap released */
+};
+
+static struct input_state g_in[INPUT_COUNT];
+static struct soft_timer  g_sample_timer;
+static input_fn           g_fn;
+
+/* --------------------------------------------------------------------------
+ * Helpers
+ * -------------------------------------------------------------------------- */
+
+static bool has_gestures(uint8_t id)
+{
+    return pgm_read_byte(&input_cfg[id].gestures) != 0;
+}
+
+/* Needs sampling: settling, held, or waiting for a second press */
+static bool busy(uint8_t id)
+{
+    const struct input_state *s = &g_in[id];
+
+    return s->settling ||
+           (has_gestures(id) && (s->level || s->tap));
+}
+
+static void emit(uint8_t id, input_gesture_t g, uint32_t now_ms)
+{
+    if (g_fn)
+        g_fn((input_id_t)id, g, now_ms);
+}
+
+/* Debounced level changed */
+static void changed(uint8_t id, uint32_t now_ms)
+{
+    struct input_state *s = &g_in[id];
+
+    if (!has_gestures(id)) {
+        emit(id, s->level ? INPUT_GESTURE_ON : INPUT_GESTURE_OFF, now_ms);
+        return;
+    }
+
+    if (s->level) {                     /* pressed */
+        s->t0_ms      = now_ms;
+        s->long_fired = false;
+        return;
+    }
+
+    /* released */
+    if (s->long_fired)
+        return;
+
+    if (s->tap) {
+        s->tap = false;
+        emit(id, INPUT_GESTURE_DOUBLE, now_ms);
+    } else {
+        s->tap   = true;
+        s->t0_ms = now_ms;
+    }
+}
+
+/* Time-based gestures */
+static void gesture_tick(uint8_t id, uint32_t now_ms)
+{
+    struct input_state *s = &g_in[id];
+
+    if (s->level && !s->long_fired &&
+        (uint32_t)(now_ms - s->t0_ms) >= INPUT_LONG_MS) {
+        s->long_fired = true;
+        s->tap        = false;
+        emit(id, INPUT_GESTURE_LONG, now_ms);
+    }
+
+    if (!s->level && s->tap &&
+        (uint32_t)(now_ms - s->t0_ms) >= INPUT_DOUBLE_MS) {
+        s->tap = false;
+        emit(id, INPUT_GESTURE_PRESS, now_ms);
+    }
+}
+
+/* Sampling timer (periodic, INPUT_SAMPLE_MS) */
+static void input_sample(uint32_t now_ms)
+{
+    bool any = false;
+
+    for (uint8_t id = 0; id < INPUT_COUNT; id++) {
+        struct input_state *s = &g_in[id];
+
+        if (!busy(id))
+            continue;
+
+        if (input_hw_read((input_id_t)id) != s->level) {
+            s->settling = true;
+
+            if (++s->count >= pgm_read_byte(&input_cfg[id].samples)) {
+                s->level    = !s->level;
+                s->count    = 0;
+                s->settling = false;
+                changed(id, now_ms);
+            }
+        } else {
+            s->count    = 0;
+            s->settling = false;
+        }
+
+        if (has_gestures(id))
+            gesture_tick(id, now_ms);
+
+        if (busy(id)) {
+            any = true;
+            continue;
+        }
+
+        /* Settled: back to interrupts. An edge in the gap shows up
+           as a level mismatch, so sample on. */
+        input_hw_arm((input_id_t)id);
+
+        if (input_hw_read((input_id_t)id) != s->level) {
+            s->settling = true;
+            any = true;
+        }
+    }
+
+    if (!any)
+        timer_stop(&g_sample_timer);
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void input_init(input_fn fn, uint32_t now_ms)
+{
+    g_fn = fn;
+
+    timer_stop(&g_sample_timer);
+    input_hw_init();
+
+    for (uint8_t id = 0; id < INPUT_COUNT; id++) {
+        struct input_state *s = &g_in[id];
+        bool raw = input_hw_read((input_id_t)id);
+
+        *s = {};
+        s->level = has_gestures(id) ? false : raw;
+
+        input_hw_arm((input_id_t)id);
+
+        if (raw != s->level)
+            input_edge((input_id_t)id, now_ms);
+    }
+}
+
+void input_edge(input_id_t id, uint32_t edge_ms)
+{
+    if (id >= INPUT_COUNT)
+        return;
+
+    g_in[id].settling = true;
+
+    if (!timer_armed(&g_sample_timer))
+        timer_start(&g_sample_timer, input_sample, edge_ms,
+                    INPUT_SAMPLE_MS, INPUT_SAMPLE_MS);
+}
+
+bool input_level(input_id_t id)
+{
+    return id < INPUT_COUNT && g_in[id].level;
+}
+
+bool input_active(void)
+{
+    return timer_armed(&g_sample_timer);
+}
@@ -0,0 +1,83 @@
+/*
+ * input.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Debounced inputs and button gestures
+ *
+ * Design:
+ *  - Interrupt-driven at rest: an edge interrupt (queued through
+ *    irq_queue) is reported with input_edge(); only then does a
+ *    soft timer sample the raw levels every INPUT_SAMPLE_MS
+ *  - A level is accepted after it reads the same for the input's
+ *    whole debounce window
+ *  - Sampling stops, and the edge interrupt is re-armed, once
+ *    every input has settled and no gesture window is open
+ *  - Never blocks: everything runs from timer_run()
+ *
+ * Inputs:
+ *  - DOOR_SW   : momentary, gestures (press / double / long)
+ *  - CONFIG_SW : slide switch, debounced level only
+ *
+ * Gestures (DOOR_SW):
+ *  - PRESS  : released before INPUT_LONG_MS, no second press within
+ *             INPUT_DOUBLE_MS of the release
+ *  - DOUBLE : second press within INPUT_DOUBLE_MS
+ *  - LONG   : held INPUT_LONG_MS; fires while still held, the
+ *             release is then ignored
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define INPUT_SAMPLE_MS   5u
+#define INPUT_LONG_MS     1500u
+#define INPUT_DOUBLE_MS   350u
+
+typedef enum : uint8_t {
+    INPUT_DOOR_SW = 0,
+    INPUT_CONFIG_SW,
+    INPUT_COUNT
+} input_id_t;
+
+typedef enum : uint8_t {
+    INPUT_GESTURE_PRESS = 0,
+    INPUT_GESTURE_DOUBLE,
+    INPUT_GESTURE_LONG,
+    INPUT_GESTURE_ON,           /* level input settled active   */
+    INPUT_GESTURE_OFF           /* level input settled inactive */
+} input_gesture_t;
+
+/* Gesture / level change handler (main context, from timer_run()) */
+typedef void (*input_fn)(input_id_t id, input_gesture_t g, uint32_t now_ms);
+
+/*
+ * Seed the debounced levels from the pins and arm the edge
+ * interrupts. A momentary input starts released.
+ */
+void input_init(input_fn fn, uint32_t now_ms);
+
+/* An edge interrupt fired for id at edge_ms (main context) */
+void input_edge(input_id_t id, uint32_t edge_ms);
+
+/* Debounced level (true = asserted) */
+bool input_level(input_id_t id);
+
+/* Sampling or a gesture window is in progress */
+bool input_active(void);
+
+/* --------------------------------------------------------------------------
+ * Platform
+ * -------------------------------------------------------------------------- */
+
+/* Enable the edge interrupt sources (once) */
+void input_hw_init(void);
+
+/* Raw level, true = asserted */
+bool input_hw_read(input_id_t id);
+
+/* Re-enable the edge interrupt for id (masked by its ISR) */
+void input_hw_arm(input_id_t id);
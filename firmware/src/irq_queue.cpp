@@ -0,0 +1,86 @@
+/*
+ * irq_queue.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: ISR → main loop event queue (see irq_queue.h)
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "irq_queue.h"
+#include "uptime.h"
+
+#define IRQ_QUEUE_MASK  (IRQ_QUEUE_SIZE - 1u)
+
+static_assert((IRQ_QUEUE_SIZE & IRQ_QUEUE_MASK) == 0,
+              "IRQ_QUEUE_SIZE must be a power of two");
+
+/* Slots are published / released by the index stores; the barrier
+   keeps the compiler from moving slot accesses across them */
+#define IRQ_BARRIER()  __asm__ __volatile__("" ::: "memory")
+
+static struct irq_event  g_ring[IRQ_QUEUE_SIZE];
+static volatile uint8_t  g_head = 0;    /* written by producer only */
+static volatile uint8_t  g_tail = 0;    /* written by consumer only */
+static volatile uint8_t  g_dropped = 0;
+
+bool irq_queue_push(irq_ev_t type)
+{
+    uint8_t h    = g_head;
+    uint8_t next = (uint8_t)((h + 1u) & IRQ_QUEUE_MASK);
+
+    if (next == g_tail) {
+        if (g_dropped != 0xFF)
+            g_dropped++;
+        return false;
+    }
+
+    g_ring[h].type  = type;
+    g_ring[h].ticks = uptime_ticks();
+
+    IRQ_BARRIER();
+    g_head = next;
+
+    return true;
+}
+
+bool irq_queue_peek(struct irq_event *out)
+{
+    uint8_t t = g_tail;
+
+    if (t == g_head)
+        return false;
+
+    IRQ_BARRIER();
+    *out = g_ring[t];
+
+    return true;
+}
+
+bool irq_queue_pop(struct irq_event *out)
+{
+    if (!irq_queue_peek(out))
+        return false;
+
+    IRQ_BARRIER();
+    g_tail = (uint8_t)((g_tail + 1u) & IRQ_QUEUE_MASK);
+
+    return true;
+}
+
+bool irq_queue_empty(void)
+{
+    return g_tail == g_head;
+}
+
+uint8_t irq_queue_dropped(void)
+{
+    return g_dropped;
+}
+
+uint32_t irq_event_ms(const struct irq_event *ev)
+{
+    uint32_t age_ticks = uptime_ticks() - ev->ticks;
+
+    return uptime_millis() - age_ticks / (1000u / UPTIME_TICK_US);
+}
@@ -0,0 +1,66 @@
+/*
+ * irq_queue.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: ISR → main loop event queue
+ *
+ * Design:
+ *  - Single-producer / single-consumer ring, no locking:
+ *      producer = ISR context (AVR ISRs do not nest, so every
+ *                 vector is one producer)
+ *      consumer = main loop
+ *  - Byte head / tail indexes: each side writes only its own
+ *    index, and a byte store is atomic on AVR
+ *  - Each event carries the raw uptime tick count taken in the
+ *    ISR, so ordering and edge times survive a late drain
+ *  - Full queue: the event is dropped and counted (never
+ *    overwrites unread events)
+ *
+ * Notes:
+ *  - irq_queue_push() from ISR context (or with interrupts
+ *    disabled) only
+ *  - Empty queue is the main loop's "nothing happened" condition
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define IRQ_QUEUE_SIZE  16u     /* power of two */
+
+typedef enum : uint8_t {
+    IRQ_EV_RTC_ALARM = 0,       /* INT0: RTC alarm line low          */
+    IRQ_EV_BUTTON,              /* INT1: door button pressed         */
+    IRQ_EV_IDLE_WAKE,           /* Timer1 compB: IDLE deadline wake  */
+    IRQ_EV_CONFIG_SW,           /* PCINT22: CONFIG switch edge       */
+    IRQ_EV_COUNT
+} irq_ev_t;
+
+struct irq_event {
+    irq_ev_t type;
+    uint32_t ticks;             /* uptime_ticks() at the ISR */
+};
+
+/* Queue an event (ISR context). false if full (dropped) */
+bool irq_queue_push(irq_ev_t type);
+
+/* Oldest event without removing it; false if empty */
+bool irq_queue_peek(struct irq_event *out);
+
+/* Remove and return the oldest event; false if empty */
+bool irq_queue_pop(struct irq_event *out);
+
+bool irq_queue_empty(void);
+
+/* Events dropped on a full queue since boot (saturating) */
+uint8_t irq_queue_dropped(void);
+
+/*
+ * Event time in the uptime_millis() domain (main context).
+ *
+ * Exact for events younger than the tick counter wrap (~9.5 h).
+ */
+uint32_t irq_event_ms(const struct irq_event *ev);
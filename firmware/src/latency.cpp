@@ -0,0 +1,124 @@
+/*
+ * latency.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Wake-to-action / wake-to-sleep latency histograms
+ *
+ * Notes:
+ *  - ISR side writes the wake stamp only while armed; arming
+ *    happens with interrupts disabled just before sleep_cpu(),
+ *    so main context never races a half-written stamp
+ *  - Binning happens in main context
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "latency.h"
+#include "uptime.h"
+
+#include <string.h>
+
+/* --------------------------------------------------------------------------
+ * Internal state
+ * -------------------------------------------------------------------------- */
+
+static volatile bool     g_armed   = false;     /* sleeping, next ISR is the wake */
+static volatile bool     g_open    = false;     /* a wake is being measured */
+static volatile uint8_t  g_src     = LAT_SRC_RTC;
+static volatile uint32_t g_wake_us = 0;
+
+static bool g_action_seen = false;
+
+static uint32_t g_boot_ms = 0;                  /* boot to first sleep */
+
+static struct lat_hist g_hist[LAT_HIST_COUNT][LAT_SRC_COUNT];
+
+/* --------------------------------------------------------------------------
+ * Helpers
+ * -------------------------------------------------------------------------- */
+
+static uint8_t bucket_of(uint32_t us)
+{
+    uint8_t b = 0;
+
+    while (us > 1u && b < (LAT_BUCKETS - 1u)) {
+        us >>= 1;
+        b++;
+    }
+
+    return b;
+}
+
+static void record(lat_hist_t which, uint32_t now_us)
+{
+    struct lat_hist *h = &g_hist[which][g_src];
+    uint32_t dt = (uint32_t)(now_us - g_wake_us);
+
+    uint8_t b = bucket_of(dt);
+    if (h->bucket[b] != 0xFFFFu)
+        h->bucket[b]++;
+
+    if (h->n != 0xFFFFu)
+        h->n++;
+
+    if (dt > h->max_us)
+        h->max_us = dt;
+}
+
+/* --------------------------------------------------------------------------
+ * Public API
+ * -------------------------------------------------------------------------- */
+
+void latency_isr_wake(lat_src_t src)
+{
+    if (!g_armed)
+        return;
+
+    g_armed   = false;
+    g_wake_us = uptime_micros();
+    g_src     = (uint8_t)src;
+    g_open    = true;
+}
+
+void latency_mark_action(void)
+{
+    if (!g_open || g_action_seen)
+        return;
+
+    g_action_seen = true;
+    record(LAT_WAKE_TO_ACTION, uptime_micros());
+}
+
+void latency_mark_sleep(void)
+{
+    if (g_boot_ms == 0) {
+        g_boot_ms = uptime_millis();
+        if (g_boot_ms == 0)
+            g_boot_ms = 1;
+    }
+
+    if (g_open)
+        record(LAT_WAKE_TO_SLEEP, uptime_micros());
+
+    g_open        = false;
+    g_action_seen = false;
+    g_armed       = true;
+}
+
+const struct lat_hist *latency_hist(lat_hist_t which, lat_src_t src)
+{
+    if ((uint8_t)which >= LAT_HIST_COUNT || (uint8_t)src >= LAT_SRC_COUNT)
+        return NULL;
+
+    return &g_hist[which][src];
+}
+
+uint32_t latency_boot_to_sleep_ms(void)
+{
+    return g_boot_ms;
+}
+
+void latency_reset(void)
+{
+    memset(g_hist, 0, sizeof(g_hist));
+}
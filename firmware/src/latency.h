@@ -0,0 +1,68 @@
+/*
+ * latency.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Wake-to-action / wake-to-sleep latency histograms
+ *
+ * Design:
+ *  - Wake timestamp captured at INT0 / INT1 ISR entry
+ *  - Action timestamp captured when a device is actually driven
+ *    (first action of the wake only)
+ *  - Sleep timestamp captured immediately before sleep_cpu()
+ *  - The first sleep after boot also records boot-to-first-sleep
+ *  - Deltas are binned into log2 buckets of microseconds,
+ *    per wake source
+ *
+ * Notes:
+ *  - Only wakes out of PWR_DOWN are measured: the ISR stamp is
+ *    armed by latency_mark_sleep() and consumed by the first ISR
+ *  - uptime_micros() wraps every ~71 min; longer intervals are
+ *    not meaningful and land in the top bucket at best
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Bucket i holds [2^i, 2^(i+1)) us; bucket 0 also holds 0.
+ * The last bucket also holds everything above it (~8 s and up). */
+#define LAT_BUCKETS  24u
+
+typedef enum {
+    LAT_SRC_RTC = 0,            /* INT0 */
+    LAT_SRC_BUTTON,             /* INT1 */
+    LAT_SRC_COUNT
+} lat_src_t;
+
+typedef enum {
+    LAT_WAKE_TO_ACTION = 0,
+    LAT_WAKE_TO_SLEEP,
+    LAT_HIST_COUNT
+} lat_hist_t;
+
+struct lat_hist {
+    uint16_t bucket[LAT_BUCKETS];   /* saturating */
+    uint16_t n;                     /* saturating */
+    uint32_t max_us;
+};
+
+/* ISR entry stamp. Interrupts must be disabled (ISR context). */
+void latency_isr_wake(lat_src_t src);
+
+/* A device was driven (main context) */
+void latency_mark_action(void);
+
+/* About to sleep_cpu() (interrupts disabled) */
+void latency_mark_sleep(void);
+
+/* Histogram for reporting; NULL if out of range */
+const struct lat_hist *latency_hist(lat_hist_t which, lat_src_t src);
+
+/* Clear all histograms */
+void latency_reset(void);
+
+/* Uptime at the first sleep since boot, 0 until then */
+uint32_t latency_boot_to_sleep_ms(void);
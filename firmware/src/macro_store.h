@@ -0,0 +1,54 @@
+/*
+ * macro_store.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Named console command scripts (EEPROM)
+ *
+ * Design:
+ *  - Fixed table of MACRO_SLOTS records in spare EEPROM
+ *  - A record is a name and a body; the body is a console line
+ *    with ';'-separated commands, replayed by 'macro run'
+ *  - Only the name and the used part of the body are written
+ *
+ * Notes:
+ *  - EEPROM contents are untrusted: names must be printable and
+ *    NUL-terminated, otherwise the slot reads as empty
+ *  - Writes are blocking (console cold path, ~3.3 ms per
+ *    changed byte)
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define MACRO_SLOTS     8u
+#define MACRO_NAME_MAX  8u      /* characters, without NUL */
+#define MACRO_BODY_MAX  118u    /* characters, without NUL */
+
+/*
+ * Store (or replace) a macro.
+ *
+ * Returns false if the name or body is empty / too long,
+ * or every slot is taken by another name.
+ */
+bool macro_store_define(const char *name, const char *body);
+
+/* Remove a macro; false if not found */
+bool macro_store_delete(const char *name);
+
+/*
+ * Copy a macro body into out (MACRO_BODY_MAX + 1 bytes).
+ *
+ * Returns false if not found.
+ */
+bool macro_store_read(const char *name, char *out);
+
+/*
+ * Name in a slot, for listing (out: MACRO_NAME_MAX + 1 bytes).
+ *
+ * Returns false if the slot is empty.
+ */
+bool macro_store_name(uint8_t slot, char *out);
@@ -0,0 +1,69 @@
+/*
+ * mem.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: SRAM usage and stack-depth monitoring
+ *
+ * Design:
+ *  - Free SRAM (between end of static data and SP) is painted
+ *    with a fixed pattern before main() runs
+ *  - Stack peak = deepest byte no longer holding the pattern
+ *  - A small canary at the bottom of the painted area is checked
+ *    from the main loop; if it is ever overwritten the stack has
+ *    reached static data, and the system is reset through the
+ *    watchdog with the reason kept in .noinit RAM
+ *
+ * Notes:
+ *  - No heap is used in this firmware; everything above
+ *    __heap_start belongs to the stack
+ *  - Static RAM per object: `make ram-report`
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Why the previous boot was forced to reset */
+typedef enum {
+    MEM_TRIP_NONE = 0,
+    MEM_TRIP_STACK_CANARY
+} mem_trip_t;
+
+struct mem_info {
+    uint16_t ram_total;         /* bytes of internal SRAM */
+    uint16_t data;              /* .data */
+    uint16_t bss;               /* .bss */
+    uint16_t noinit;            /* .noinit */
+    uint16_t stack_now;         /* current stack depth */
+    uint16_t stack_peak;        /* deepest stack since boot */
+    uint16_t free_now;          /* SP down to end of static data */
+    uint16_t free_min;          /* least free ever (untouched paint) */
+};
+
+/*
+ * Capture and clear the previous trip reason.
+ *
+ * - Called once at boot, before anything else uses .noinit
+ */
+void mem_init(void);
+
+/* Trip reason recorded by the previous boot */
+mem_trip_t mem_last_trip(void);
+
+/*
+ * Verify the stack canary.
+ *
+ * - Cheap; called every main loop pass
+ * - Does not return if the canary is broken
+ */
+void mem_check(void);
+
+/*
+ * Fill in current usage.
+ *
+ * - Scans the painted area (console / cold path only)
+ */
+void mem_get_info(struct mem_info *out);
@@ -0,0 +1,106 @@
+/*
+ * metrics.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Runtime metrics registry (monotonic counters)
+ *
+ * Design:
+ *  - Every counter is declared ONCE in METRICS_LIST
+ *  - Ids are a uint8_t enum; storage is a fixed uint32_t table
+ *  - metric_inc() is an inline increment of a constant address:
+ *    no call, no bounds check at runtime
+ *  - Counts are restored from an EEPROM snapshot at boot and
+ *    snapshotted once per day (optional, METRICS_SNAPSHOT)
+ *
+ * Notes:
+ *  - Main context only (not ISR safe)
+ *  - Adding/removing a counter invalidates the stored snapshot
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Set to 0 to keep counters in RAM only */
+#ifndef METRICS_SNAPSHOT
+#define METRICS_SNAPSHOT 1
+#endif
+
+/*
+ * Canonical counter list
+ * id, printed name
+ */
+#define METRICS_LIST(X) \
+    X(WAKE_RTC,          "wake_rtc")          \
+    X(WAKE_BUTTON,       "wake_button")       \
+    X(WAKE_SPURIOUS,     "wake_spurious")     \
+    X(I2C_PING_FAIL,     "i2c_ping_fail")     \
+    X(I2C_PING_TIMEOUT,  "i2c_ping_timeout")  \
+    X(I2C_WRITE_FAIL,    "i2c_write_fail")    \
+    X(I2C_WRITE_TIMEOUT, "i2c_write_timeout") \
+    X(I2C_READ_FAIL,     "i2c_read_fail")     \
+    X(I2C_READ_TIMEOUT,  "i2c_read_timeout")  \
+    X(RTC_OSF,           "rtc_os_flag")       \
+    X(RTC_STALL,         "rtc_osc_stall")     \
+    X(CONFIG_LOAD_FAIL,  "config_load_fail")  \
+    X(ETAG_BUMP,         "schedule_etag")     \
+    X(DOOR_BUTTON,       "door_button")       \
+    X(DOOR_SAVED_MS,     "door_saved_ms")     \
+    X(LED_MODE,          "led_mode_change")
+
+#define METRIC_ENUM(id, name) METRIC_##id,
+
+typedef enum : uint8_t {
+    METRICS_LIST(METRIC_ENUM)
+    METRIC_COUNT
+} metric_id_t;
+
+#undef METRIC_ENUM
+
+extern uint32_t g_metrics[METRIC_COUNT];
+
+static inline void metric_inc(metric_id_t id)
+{
+    g_metrics[id]++;
+}
+
+/* Accumulating counters (e.g. milliseconds) */
+static inline void metric_add(metric_id_t id, uint32_t n)
+{
+    g_metrics[id] += n;
+}
+
+static inline uint32_t metric_get(metric_id_t id)
+{
+    return g_metrics[id];
+}
+
+/*
+ * Restore counters from the EEPROM snapshot (if valid).
+ *
+ * - Called once at boot
+ */
+void metrics_init(void);
+
+/*
+ * Start a snapshot of the current counters.
+ *
+ * - Counters are copied immediately; bytes are written
+ *   through ee_async by metrics_service()
+ */
+void metrics_snapshot(void);
+
+/* Feed pending snapshot bytes to the EEPROM queue (main loop) */
+void metrics_service(void);
+
+/* True while a snapshot is still being written */
+bool metrics_busy(void);
+
+/* Zero all counters (RAM only; snapshot to persist) */
+void metrics_clear(void);
+
+/* Printed name (flash string) */
+const char *metric_name_P(uint8_t id);
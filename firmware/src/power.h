@@ -0,0 +1,59 @@
+/*
+ * power.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Power-reduction manager
+ *
+ * Design:
+ *  - Peripherals that are never used are powered off once (PRR)
+ *  - Unused pins are parked in a defined low-leakage state once
+ *  - Drivers register prepare / resume hooks; the sleep path
+ *    runs every prepare hook before PWR_DOWN and every resume
+ *    hook (in reverse order) after wake
+ *
+ * Notes:
+ *  - Fixed-size hook table, no dynamic allocation
+ *  - Registration is idempotent (re-init paths may call it again)
+ *  - Hooks run in main context with interrupts enabled
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#define POWER_MAX_HOOKS  8u
+
+typedef void (*power_hook_fn)(void);
+
+struct power_hooks {
+    const char   *name;         /* flash string */
+    power_hook_fn prepare;      /* before sleep (may be NULL) */
+    power_hook_fn resume;       /* after wake   (may be NULL) */
+};
+
+/*
+ * One-time power reduction:
+ *  - ADC and analog comparator off
+ *  - Unused peripherals gated in PRR0 / PRR1
+ *  - Unused pins to input with pull-up
+ */
+void power_init(void);
+
+/*
+ * Register a driver's sleep hooks.
+ *
+ * Returns false if the table is full.
+ */
+bool power_register(const struct power_hooks *h);
+
+/* Run all prepare hooks (registration order) */
+void power_sleep_prepare(void);
+
+/* Run all resume hooks (reverse registration order) */
+void power_sleep_resume(void);
+
+/* Console report: which peripherals are powered */
+void power_report(void);
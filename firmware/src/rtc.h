@@ -13,7 +13,8 @@
  * Time Model:
  *  - RTC stores LOCAL time.
  *  - Epoch helpers convert LOCAL → UTC.
- *  - Epoch base is 2000-01-01 00:00:00 UTC.
+ *  - Epoch is Unix time: seconds since 1970-01-01 00:00:00 UTC
+ *    (dates before 2000 are not supported).
  *
  * Notes:
  *  - Offline system
@@ -61,8 +62,8 @@ bool rtc_oscillator_running(void);
 /**
  * @brief Lightweight check that RTC time has been set.
  *
- * This function performs a non-blocking check of the OS flag only.
- * It does NOT verify oscillator motion.
+ * This function performs a non-blocking check of the OS flag and
+ * of the background oscillator verdict (see rtc_osc_service()).
  *
  * Safe for use inside the main loop.
  *
@@ -72,16 +73,14 @@ bool rtc_oscillator_running(void);
 bool rtc_time_is_set(void);
 
 /**
- * @brief Perform a blocking RTC integrity validation at system startup.
+ * @brief Provisional RTC integrity check at system startup.
  *
  * ============================================================================
  * PURPOSE
  * ============================================================================
  *
- * This function performs a full physical validation of the PCF8523 RTC.
- * It is intended to be called ONCE during system boot.
- *
- * This is NOT a lightweight status check.
+ * Fast-boot validation of the PCF8523 RTC. It is intended to be
+ * called ONCE during system boot, and does not block.
  *
  * ============================================================================
  * WHAT IT VERIFIES
@@ -90,42 +89,59 @@ bool rtc_time_is_set(void);
  * 1. I2C communication is functional.
  * 2. The STOP bit in CONTROL_1 is clear (oscillator not halted).
  * 3. The OS (Oscillator Stop) flag in the Seconds register is clear.
- * 4. The seconds register advances over ~1 second, proving the crystal
- *    oscillator is physically running.
+ *
+ * Proof that the seconds register advances (crystal physically
+ * running) is deferred to rtc_osc_service(), so the schedule can
+ * be applied immediately after a reset.
  *
  * ============================================================================
  * BEHAVIOR
  * ============================================================================
  *
- * - Blocks for approximately 1.1 seconds while verifying seconds rollover.
- * - Performs multiple I2C reads.
+ * - Does NOT block.
  * - Does NOT modify time.
  * - Does NOT clear the OS flag.
  *
- * ============================================================================
- * SYSTEM CONTRACT
- * ============================================================================
- *
- * This function must:
- *
- *  - Be called during boot only.
- *  - NOT be called from the main loop.
- *  - NOT be used for periodic health checks.
- *
- * If this function returns false, the RTC is considered invalid and the
- * entire system time base must be treated as invalid.
- *
- * The system design explicitly states:
+ * If the background check later proves the oscillator stalled,
+ * rtc_time_is_set() returns false from then on:
  *
  *     If the RTC is invalid, the system is invalid.
  *
  * ============================================================================
  *
- * @return true  RTC oscillator confirmed running and time considered valid.
+ * @return true  RTC provisionally valid.
  * @return false RTC failed integrity validation.
  */
 bool rtc_validate_at_boot(void);
 
+/* --------------------------------------------------------------------------
+ * Background oscillator proof
+ * -------------------------------------------------------------------------- */
+
+typedef enum {
+    RTC_OSC_UNVERIFIED = 0,     /* provisional */
+    RTC_OSC_VERIFIED,           /* seconds advanced */
+    RTC_OSC_STALLED             /* no motion over the proof window */
+} rtc_osc_state_t;
+
+/**
+ * @brief Advance the oscillator proof (main loop, every pass).
+ *
+ * One short I2C read until a verdict, then nothing.
+ * Clears a stale OS flag once the oscillator is proven running.
+ */
+void rtc_osc_service(uint32_t now_ms);
+
+/**
+ * @brief Credit time slept with a bounded wake (e.g. watchdog).
+ *
+ * Uptime pauses in PWR_DOWN; only sleep of known length counts
+ * toward the proof window.
+ */
+void rtc_osc_credit_ms(uint32_t ms);
+
+rtc_osc_state_t rtc_osc_state(void);
+
 /* --------------------------------------------------------------------------
  * Time API (LOCAL civil time)
  * -------------------------------------------------------------------------- */
@@ -167,6 +183,15 @@ void rtc_alarm_disable(void);
  */
 void rtc_alarm_clear_flag(void);
 
+/**
+ * @brief Alarm serviced: release the INT line and re-arm INT0.
+ *
+ * INT0 is low-level triggered and its ISR masks itself, so it is
+ * only unmasked once the line reads released; left masked, the
+ * MCU would sleep through every later alarm.
+ */
+void rtc_alarm_int_rearm(void);
+
 /* --------------------------------------------------------------------------
  * Scheduler Support
  * -------------------------------------------------------------------------- */
@@ -187,14 +212,14 @@ uint16_t rtc_minutes_since_midnight(void);
 bool rtc_alarm_set_minute_of_day(uint16_t minute_of_day);
 
 /* --------------------------------------------------------------------------
- * Epoch Helpers (UTC-normalized, 2000 base)
+ * Epoch Helpers (UTC-normalized, Unix base)
  * -------------------------------------------------------------------------- */
 
 /**
  * @brief Get current UTC epoch seconds.
  *
  * Returns seconds since:
- *   2000-01-01 00:00:00 UTC
+ *   1970-01-01 00:00:00 UTC (Unix time)
  *
  * Behavior:
  *  - Reads LOCAL time from RTC.
@@ -218,7 +243,7 @@ uint32_t rtc_get_epoch(void);
  * @param tz_hours   Timezone offset from UTC
  * @param honor_dst  Apply US DST rule if true
  *
- * @return Seconds since 2000-01-01 00:00:00 UTC.
+ * @return Seconds since 1970-01-01 00:00:00 UTC (Unix time).
  *
  * Notes:
  *  - Input time is interpreted as LOCAL civil time.
@@ -231,3 +256,25 @@ uint32_t rtc_epoch_from_ymdhms(
     int h, int m, int s,
     int tz_hours,
     bool honor_dst);
+
+/**
+ * @brief Convert UTC epoch seconds back to LOCAL calendar time.
+ *
+ * Inverse of rtc_epoch_from_ymdhms().
+ *
+ * @param epoch      Value produced by rtc_epoch_from_ymdhms()/rtc_get_epoch()
+ * @param tz_hours   Timezone offset from UTC
+ * @param honor_dst  Apply US DST rule if true
+ *
+ * Notes:
+ *  - Deterministic, no hardware access.
+ *  - Any output pointer may be NULL.
+ *  - DST is decided on the standard-time hour, so the repeated
+ *    hour at the November changeover reports as standard time.
+ */
+void rtc_ymdhms_from_epoch(
+    uint32_t epoch,
+    int tz_hours,
+    bool honor_dst,
+    int *y, int *mo, int *d,
+    int *h, int *m, int *s);
@@ -12,7 +12,7 @@
  * Time Model:
  *  - RTC stores LOCAL civil time.
  *  - Epoch functions convert LOCAL time → UTC.
- *  - Epoch base is 2000-01-01 00:00:00 UTC.
+ *  - Epoch is Unix time (seconds since 1970-01-01 00:00:00 UTC).
  *
  * Notes:
  *  - Offline system
@@ -126,7 +126,7 @@ static int days_in_month(int y, int mo)
  * @param tz_hours   Timezone offset from UTC in hours
  * @param honor_dst  If true, apply US DST rules via is_us_dst()
  *
- * @return Seconds since 2000-01-01 00:00:00 UTC.
+ * @return Seconds since 1970-01-01 00:00:00 UTC (Unix time).
  *
  * Description:
  *  - Treats input time as LOCAL civil time.
@@ -138,7 +138,7 @@ static int days_in_month(int y, int mo)
  * Design Constraints:
  *  - Deterministic, no hardware access.
  *  - Valid for years >= 2000.
- *  - 32-bit safe through year 2136.
+ *  - 32-bit safe through year 2106.
  *  - Caller must supply valid calendar values.
  */
 
@@ -216,3 +216,72 @@ uint32_t rtc_get_epoch(void)
         g_cfg.honor_dst
     );
 }
+
+/**
+ * @brief Convert UTC epoch seconds to LOCAL calendar time.
+ *
+ * Description:
+ *  - Removes the Unix offset added by rtc_epoch_from_ymdhms().
+ *  - Applies timezone, then DST (decided on standard time).
+ *  - Walks years/months forward from 2000 (same calendar helpers
+ *    as the forward conversion, so the two stay consistent).
+ *
+ * Design Constraints:
+ *  - Deterministic, no hardware access.
+ *  - Epochs before 2000-01-01 clamp to 2000-01-01 00:00:00.
+ */
+static void ymdhms_from_seconds_2000(int64_t secs,
+                                     int *y, int *mo, int *d,
+                                     int *h, int *m, int *s)
+{
+    if (secs < 0)
+        secs = 0;
+
+    uint32_t days = (uint32_t)(secs / 86400LL);
+    uint32_t rem  = (uint32_t)(secs % 86400LL);
+
+    int year = 2000;
+    for (;;) {
+        uint32_t ylen = is_leap_year(year) ? 366u : 365u;
+        if (days < ylen)
+            break;
+        days -= ylen;
+        year++;
+    }
+
+    int month = 1;
+    for (;;) {
+        uint32_t mlen = (uint32_t)days_in_month(year, month);
+        if (days < mlen)
+            break;
+        days -= mlen;
+        month++;
+    }
+
+    if (y)  *y  = year;
+    if (mo) *mo = month;
+    if (d)  *d  = (int)days + 1;
+    if (h)  *h  = (int)(rem / 3600u);
+    if (m)  *m  = (int)((rem % 3600u) / 60u);
+    if (s)  *s  = (int)(rem % 60u);
+}
+
+void rtc_ymdhms_from_epoch(
+    uint32_t epoch,
+    int tz_hours,
+    bool honor_dst,
+    int *y, int *mo, int *d,
+    int *h, int *m, int *s)
+{
+    int64_t secs = (int64_t)epoch - (int64_t)UNIX_EPOCH_OFFSET_2000;
+    secs += (int64_t)tz_hours * 3600LL;
+
+    if (honor_dst) {
+        int yy, mm, dd, hh;
+        ymdhms_from_seconds_2000(secs, &yy, &mm, &dd, &hh, NULL, NULL);
+        if (is_us_dst(yy, mm, dd, hh))
+            secs += 3600LL;
+    }
+
+    ymdhms_from_seconds_2000(secs, y, mo, d, h, m, s);
+}
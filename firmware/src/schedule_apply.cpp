@@ -1,56 +1,116 @@
-#include "schedule_apply.h"
-
-#include "devices/devices.h"
-
 #include "schedule_apply.h"
 #include "devices/devices.h"
+#include "devices/device_registry.h"
 #include "console/mini_printf.h"
 #include "console/console.h"
+#include "event_log.h"
+#include "latency.h"
 
-/*
- * Apply reduced scheduler state to devices.
- *
- * This is the ONLY place where scheduled intent
- * actually turns into device actions.
- */
- void schedule_apply(const struct reduced_state *rs)
- {
-     if (!rs)
-         return;
+/* --------------------------------------------------------------------------
+ * Manual skip (per device ID bit)
+ * -------------------------------------------------------------------------- */
+
+static_assert(STATE_REDUCER_MAX_DEVICES <= 8, "skip masks are 8 bits");
+
+static uint8_t g_last_want[STATE_REDUCER_MAX_DEVICES];  /* dev_state_t */
+static uint8_t g_skip_mask;     /* swallow the next scheduled change */
+static uint8_t g_hold_mask;     /* change swallowed: hands off */
+
+/* Track scheduled changes; true if the device is held off */
+static bool skip_hold(uint8_t id, dev_state_t want)
+{
+    const uint8_t bit = (uint8_t)(1u << id);
+
+    if (g_last_want[id] != want) {
+        bool first = (g_last_want[id] == DEV_STATE_UNKNOWN);
+
+        g_last_want[id] = want;
 
-     uint8_t id;
+        if (!first) {
+            g_hold_mask &= (uint8_t)~bit;
 
-     for (bool ok = device_enum_first(&id);
-          ok;
-          ok = device_enum_next(id, &id)) {
+            if (g_skip_mask & bit) {
+                g_skip_mask &= (uint8_t)~bit;
+                g_hold_mask |= bit;
+            }
+        }
+    }
 
-         if (!rs->has_action[id])
-             continue;
+    return (g_hold_mask & bit) != 0;
+}
 
-         dev_state_t want =
-             (rs->action[id] == ACTION_ON) ? DEV_STATE_ON
-                                           : DEV_STATE_OFF;
+void schedule_apply_skip_next(uint8_t id, bool skip)
+{
+    if (id >= STATE_REDUCER_MAX_DEVICES)
+        return;
 
-         dev_state_t have;
-         if (!device_get_state_by_id(id, &have))
-             continue;
+    if (skip)
+        g_skip_mask |= (uint8_t)(1u << id);
+    else
+        g_skip_mask &= (uint8_t)~(1u << id);
+}
 
-         /* No-op if already correct */
-         if (have == want)
-             continue;
+bool schedule_apply_skip_pending(uint8_t id)
+{
+    return id < STATE_REDUCER_MAX_DEVICES &&
+           (g_skip_mask & (1u << id)) != 0;
+}
+
+/* One device; D is a registry entry, so every call is direct */
+template <typename D>
+static void apply_device(const struct reduced_state *rs)
+{
+    const uint8_t id = D::id;
+
+    static_assert(id < STATE_REDUCER_MAX_DEVICES, "reduced_state too small");
+
+    if (!rs->has_action[id])
+        return;
+
+    dev_state_t want =
+        (rs->action[id] == ACTION_ON) ? DEV_STATE_ON
+                                      : DEV_STATE_OFF;
+
+    if (skip_hold(id, want))
+        return;
+
+    /* No-op if already correct */
+    if (dev_get_state<D>() == want)
+        return;
 
 #if 0    /* ---- DEBUG: print scheduled action ---- */
 
-         const char *name = "?";
-         device_name(id, &name);
+    flash_str name = FS(QMARK);
+    device_name(id, &name);
 
-         mini_printf("\tDEBUG SCHED: %s -> %s\n",
-                     name,
-                     (want == DEV_STATE_ON) ? "ON" : "OFF");
+    mini_printf(FSTR("\tDEBUG SCHED: %S -> %S\n"),
+                name,
+                (want == DEV_STATE_ON) ? FS(ON) : FS(OFF));
 #endif
 
-         /* ---- Apply action ---- */
+    /* ---- Apply action ---- */
+
+    if (dev_set_state<D>(want)) {
+        latency_mark_action();
+        event_log_append(id,
+                         (want == DEV_STATE_ON) ? EVLOG_ACTION_ON
+                                                : EVLOG_ACTION_OFF,
+                         EVLOG_SRC_SCHEDULE);
+    }
+}
+
+/*
+ * Apply reduced scheduler state to devices.
+ *
+ * This is the ONLY place where scheduled intent
+ * actually turns into device actions.
+ */
+ void schedule_apply(const struct reduced_state *rs)
+ {
+     if (!rs)
+         return;
 
-         device_set_state_by_id(id, want);
-     }
+     registered_devices::each([rs](auto d) {
+         apply_device<decltype(d)>(rs);
+     });
  }
@@ -20,6 +20,19 @@ extern "C" {
  */
 void schedule_apply(const struct reduced_state *rs);
 
+/*
+ * Skip the next scheduled state change of one device (manual
+ * override, e.g. door button long-press).
+ *
+ * The change is swallowed when it comes due, and the device is
+ * left alone until the scheduled state changes again.
+ * skip = false cancels a pending skip (not a hold in progress).
+ */
+void schedule_apply_skip_next(uint8_t id, bool skip);
+
+/* A skip is armed and not yet consumed */
+bool schedule_apply_skip_pending(uint8_t id);
+
 #ifdef __cplusplus
 }
 #endif
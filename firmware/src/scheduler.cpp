@@ -26,6 +26,8 @@
 #include "scheduler.h"
 #include "config_events.h"
 #include "resolve_when.h"
+#include "metrics.h"
+#include "warm_state.h"
 
 #include <string.h>
 
@@ -64,6 +66,12 @@ void scheduler_init(void)
     g_schedule_etag = 0;
 }
 
+void scheduler_restore(const struct scheduler_ctx *ctx)
+{
+    if (ctx)
+        g_scheduler = *ctx;
+}
+
 /*
  * Invalidate cached solar data.
  *
@@ -146,7 +154,11 @@ uint32_t schedule_etag(void)
  */
 void schedule_touch(void)
 {
+    /* A saved day context may no longer match the inputs */
+    warm_state_invalidate();
+
     g_schedule_etag++;
+    metric_inc(METRIC_ETAG_BUMP);
 }
 
 /* --------------------------------------------------------------------------
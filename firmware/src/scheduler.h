@@ -62,6 +62,15 @@ extern struct scheduler_ctx g_scheduler;
  */
 void scheduler_init(void);
 
+/*
+ * Adopt a day context saved before a warm reset.
+ *
+ * - Called once at boot, after scheduler_init()
+ * - Lets the first scheduler_update_day() for the same date
+ *   be a no-op (no solar recompute)
+ */
+void scheduler_restore(const struct scheduler_ctx *ctx);
+
 /*
  * Invalidate cached solar data.
  *
@@ -1,5 +1,6 @@
 #pragma once
 #include <stdint.h>
+#include <stdbool.h>
 
 /*
  * system_sleep_until()
@@ -23,5 +24,47 @@
  */
 void system_sleep_until(uint16_t minute);
 
+/*
+ * system_sleep_fault()
+ *
+ * Purpose:
+ *  - Low-power wait for fault indication (no valid time, no bus)
+ *
+ * Contract:
+ *  - Returns after ~SYSTEM_SLEEP_FAULT_S seconds (watchdog interrupt),
+ *    or earlier on the door button or a CONFIG switch change
+ *    (PCINT22 is armed for the duration, then left as found)
+ *  - RTC INT is ignored for the duration (it may be stuck or unset)
+ *  - Caller flashes the fault indication between calls
+ *  - Returns true if the full period elapsed (watchdog wake)
+ *
+ * Platform behavior:
+ *  - HOST: returns immediately
+ *  - FIRMWARE: PWR_DOWN with WDT in interrupt mode
+ */
+#define SYSTEM_SLEEP_FAULT_S  2u
+
+bool system_sleep_fault(void);
+
+/*
+ * system_sleep_idle_ms()
+ *
+ * Purpose:
+ *  - Short CPU-only wait while software timers are pending
+ *
+ * Contract:
+ *  - Returns after at most ms (capped at SYSTEM_SLEEP_IDLE_MAX_MS),
+ *    or earlier on any interrupt
+ *  - Returns at once if an ISR event is queued (irq_queue.h)
+ *  - Peripherals, uptime and the console keep running
+ *
+ * Platform behavior:
+ *  - HOST: returns immediately
+ *  - FIRMWARE: IDLE sleep, Timer1 compare B as the wake
+ */
+#define SYSTEM_SLEEP_IDLE_MAX_MS  500u
+
+void system_sleep_idle_ms(uint32_t ms);
+
 
  void system_sleep_init(void);
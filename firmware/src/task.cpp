@@ -0,0 +1,127 @@
+/*
+ * task.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Cooperative stackless tasks (see task.h)
+ *
+ * Notes:
+ *  - A handful of tasks at most: every pass walks them all
+ *  - Tasks stay on the list once started, so a body may start,
+ *    stop or post to any task while the list is being walked
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "task.h"
+#include "timer.h"
+#include "uptime.h"
+
+#include <stddef.h>
+
+static struct task       *g_head = NULL;
+static struct soft_timer  g_timer;
+
+/* a is before b (wrap-safe) */
+static inline bool before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+static void task_pass(uint32_t now_ms);
+
+/* Arm the shared timer at the earliest waiting deadline */
+static void rearm(uint32_t now_ms)
+{
+    bool     any = false;
+    uint32_t earliest = 0;
+
+    for (struct task *t = g_head; t; t = t->next) {
+        if (!t->running || !t->waiting)
+            continue;
+
+        if (!any || before(t->deadline_ms, earliest))
+            earliest = t->deadline_ms;
+        any = true;
+    }
+
+    if (!any) {
+        timer_stop(&g_timer);
+        return;
+    }
+
+    uint32_t delay = before(now_ms, earliest) ? earliest - now_ms : 0u;
+
+    timer_start(&g_timer, task_pass, now_ms, delay, 0);
+}
+
+static void resume(struct task *t, uint32_t now_ms)
+{
+    t->now_ms  = now_ms;
+    t->waiting = false;
+
+    if (t->fn(t) == TASK_DONE)
+        t->running = false;
+}
+
+/* Shared timer expiry: resume every task whose wait is over */
+static void task_pass(uint32_t now_ms)
+{
+    for (struct task *t = g_head; t; t = t->next) {
+        if (t->running && t->waiting &&
+            !before(now_ms, t->deadline_ms))
+            resume(t, now_ms);
+    }
+
+    rearm(now_ms);
+}
+
+void task_wait_(struct task *t, uint32_t ms)
+{
+    /* From the wait, not the resume: a blocking call may lie between */
+    t->waiting     = true;
+    t->deadline_ms = uptime_millis() + ms;
+}
+
+void task_start(struct task *t, task_fn fn)
+{
+    if (!t || !fn)
+        return;
+
+    struct task **pp = &g_head;
+
+    while (*pp && *pp != t)
+        pp = &(*pp)->next;
+
+    if (!*pp) {
+        t->next = NULL;
+        *pp = t;
+    }
+
+    uint32_t now_ms = uptime_millis();
+
+    t->fn      = fn;
+    t->lc      = 0;
+    t->running = true;
+
+    resume(t, now_ms);
+    rearm(now_ms);
+}
+
+void task_stop(struct task *t)
+{
+    if (!t || !t->running)
+        return;
+
+    t->running = false;
+    rearm(uptime_millis());
+}
+
+bool task_busy(void)
+{
+    for (struct task *t = g_head; t; t = t->next) {
+        if (t->running)
+            return true;
+    }
+
+    return false;
+}
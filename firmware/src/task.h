@@ -0,0 +1,123 @@
+/*
+ * task.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Cooperative stackless tasks (protothreads) for actuator sequences
+ *
+ * Design:
+ *  - A task is a function resumed where it last waited; the resume
+ *    point is a switch label (__LINE__), so a task costs its struct,
+ *    not a stack, and nothing is allocated
+ *  - Waits are delays (TASK_AWAIT_MS), measured from the wait
+ *  - All waiting tasks share one soft timer armed at the earliest
+ *    task deadline, so task wake-ups are ordinary timer.h deadlines
+ *    and the main loop IDLEs until them like any other timer
+ *  - A started task blocks PWR_DOWN until it ends (task_busy()):
+ *    uptime stops there, and a half-done sequence must not wait on
+ *    the next RTC alarm
+ *
+ * Writing a task:
+ *
+ *      static struct task g_seq;
+ *
+ *      static task_status_t seq(struct task *t)
+ *      {
+ *          TASK_BEGIN(t);
+ *          relay_on();
+ *          TASK_AWAIT_MS(t, 500);
+ *          relay_off();
+ *          TASK_END(t);
+ *      }
+ *
+ *      task_start(&g_seq, seq);
+ *
+ * Rules (the usual protothread ones):
+ *  - Locals do not survive a wait; keep state in statics
+ *  - No switch statement may enclose a wait
+ *  - One wait per source line (the line number is the resume point)
+ *  - A task only yields at its waits: anything it calls that
+ *    blocks stalls the whole loop (door_lock has a split pulse
+ *    for this reason)
+ *
+ * Notes:
+ *  - Main context only (not ISR safe); bodies run from timer_run()
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef enum : uint8_t {
+    TASK_WAITING = 0,
+    TASK_DONE
+} task_status_t;
+
+struct task;
+
+typedef task_status_t (*task_fn)(struct task *t);
+
+struct task {
+    struct task *next;          /* registered list (never unlinked) */
+    task_fn      fn;
+    uint16_t     lc;            /* resume point, 0 = top */
+    uint32_t     now_ms;        /* time of the current resume */
+    uint32_t     deadline_ms;   /* valid while waiting */
+    bool         waiting;
+    bool         running;
+};
+
+/* --------------------------------------------------------------------------
+ * Body macros
+ * -------------------------------------------------------------------------- */
+
+#define TASK_BEGIN(t)   switch ((t)->lc) { case 0:
+
+#define TASK_END(t)     } (t)->lc = 0; return TASK_DONE
+
+#define TASK_YIELD_(t)                                  \
+    do {                                                \
+        (t)->lc = __LINE__;                             \
+        return TASK_WAITING;                            \
+        case __LINE__:;                                 \
+    } while (0)
+
+/* Resume ms from now */
+#define TASK_AWAIT_MS(t, ms)                            \
+    do {                                                \
+        task_wait_((t), (ms));                          \
+        TASK_YIELD_(t);                                 \
+    } while (0)
+
+/* --------------------------------------------------------------------------
+ * API
+ * -------------------------------------------------------------------------- */
+
+/*
+ * (Re)start t at its top and run it up to its first wait before
+ * returning, so the caller sees the sequence's first effects.
+ * A task already running is restarted. Not from t's own body.
+ */
+void task_start(struct task *t, task_fn fn);
+
+/* Abandon t where it waits (the caller makes the hardware safe) */
+void task_stop(struct task *t);
+
+static inline bool task_running(const struct task *t)
+{
+    return t->running;
+}
+
+/* Current resume time (uptime_millis domain) */
+static inline uint32_t task_now(const struct task *t)
+{
+    return t->now_ms;
+}
+
+/* Any task started and not yet ended (blocks PWR_DOWN) */
+bool task_busy(void);
+
+/* Used by the wait macros */
+void task_wait_(struct task *t, uint32_t ms);
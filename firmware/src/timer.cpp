@@ -0,0 +1,120 @@
+/*
+ * timer.cpp
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Software timers (sorted deadline list)
+ *
+ * Notes:
+ *  - A handful of timers at most: O(n) insert, O(1) next deadline
+ *
+ * Updated: 2026-10-18
+ */
+
+#include "timer.h"
+
+#include <stddef.h>
+
+static struct soft_timer *g_head = NULL;
+
+/* a is before b (wrap-safe) */
+static inline bool before(uint32_t a, uint32_t b)
+{
+    return (int32_t)(a - b) < 0;
+}
+
+static void list_remove(struct soft_timer *t)
+{
+    struct soft_timer **pp = &g_head;
+
+    while (*pp) {
+        if (*pp == t) {
+            *pp = t->next;
+            break;
+        }
+        pp = &(*pp)->next;
+    }
+
+    t->next  = NULL;
+    t->armed = false;
+}
+
+/* Insert after any timer with the same deadline (FIFO on ties) */
+static void list_insert(struct soft_timer *t)
+{
+    struct soft_timer **pp = &g_head;
+
+    while (*pp && !before(t->deadline_ms, (*pp)->deadline_ms))
+        pp = &(*pp)->next;
+
+    t->next  = *pp;
+    *pp      = t;
+    t->armed = true;
+}
+
+void timer_start(struct soft_timer *t,
+                 soft_timer_fn fn,
+                 uint32_t now_ms,
+                 uint32_t delay_ms,
+                 uint32_t period_ms)
+{
+    if (!t || !fn)
+        return;
+
+    if (t->armed)
+        list_remove(t);
+
+    t->fn          = fn;
+    t->deadline_ms = now_ms + delay_ms;
+    t->period_ms   = period_ms;
+
+    list_insert(t);
+}
+
+void timer_stop(struct soft_timer *t)
+{
+    if (t && t->armed)
+        list_remove(t);
+}
+
+void timer_run(uint32_t now_ms)
+{
+    while (g_head && !before(now_ms, g_head->deadline_ms)) {
+
+        struct soft_timer *t = g_head;
+
+        g_head   = t->next;
+        t->next  = NULL;
+        t->armed = false;
+
+        if (t->period_ms) {
+            /* Keep phase; skip periods missed while busy */
+            do {
+                t->deadline_ms += t->period_ms;
+            } while (!before(now_ms, t->deadline_ms));
+
+            list_insert(t);
+        }
+
+        /* May re-arm or stop t (or any other timer) */
+        t->fn(now_ms);
+    }
+}
+
+bool timer_pending(void)
+{
+    return g_head != NULL;
+}
+
+bool timer_next_deadline(uint32_t now_ms, uint32_t *ms_left)
+{
+    if (!g_head)
+        return false;
+
+    if (ms_left) {
+        *ms_left = before(now_ms, g_head->deadline_ms)
+                 ? (uint32_t)(g_head->deadline_ms - now_ms)
+                 : 0u;
+    }
+
+    return true;
+}
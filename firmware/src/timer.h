@@ -0,0 +1,71 @@
+/*
+ * timer.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Software timers (one-shot / periodic, uptime_millis domain)
+ *
+ * Design:
+ *  - Caller owns the storage (static struct soft_timer), no allocation
+ *  - Armed timers sit on one list sorted by deadline, so the
+ *    earliest deadline is the list head and timer_run() stops at
+ *    the first timer that is not yet due
+ *  - Callbacks run from timer_run() in main context and may
+ *    start / stop any timer, including their own
+ *  - Deadlines compare with wrap-safe signed differences
+ *
+ * Notes:
+ *  - Main context only (not ISR safe)
+ *  - Resolution is whatever the main loop cadence allows;
+ *    callbacks may run late, never early
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef void (*soft_timer_fn)(uint32_t now_ms);
+
+struct soft_timer {
+    struct soft_timer *next;        /* sorted armed list */
+    uint32_t           deadline_ms;
+    uint32_t           period_ms;   /* 0 = one-shot */
+    soft_timer_fn      fn;
+    bool               armed;
+};
+
+/*
+ * Arm (or re-arm) a timer to fire delay_ms after now_ms.
+ *
+ * period_ms = 0 → one-shot; otherwise re-armed every period_ms
+ * after each expiry (phase kept, missed periods are not replayed).
+ */
+void timer_start(struct soft_timer *t,
+                 soft_timer_fn fn,
+                 uint32_t now_ms,
+                 uint32_t delay_ms,
+                 uint32_t period_ms);
+
+/* Disarm (no-op if not armed) */
+void timer_stop(struct soft_timer *t);
+
+static inline bool timer_armed(const struct soft_timer *t)
+{
+    return t->armed;
+}
+
+/* Run the callbacks of every timer due at now_ms */
+void timer_run(uint32_t now_ms);
+
+/* True if any timer is armed */
+bool timer_pending(void);
+
+/*
+ * Time until the earliest deadline.
+ *
+ * Returns false if nothing is armed; *ms_left is 0 when a
+ * timer is already due.
+ */
+bool timer_next_deadline(uint32_t now_ms, uint32_t *ms_left);
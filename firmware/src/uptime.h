@@ -9,18 +9,38 @@
  *  - Deterministic behavior
  *  - No network dependencies
  *
- * Updated: 2025-12-29
+ * Updated: 2026-10-18
  */
 
 #pragma once
 
 #include <stdint.h>
 
+// Timebase resolution (one timer tick)
+#define UPTIME_TICK_US  8u
+
 // Initialize uptime timebase (firmware). Host may stub.
 void uptime_init(void);
 
-// Monotonic seconds since boot.
+// Monotonic seconds since boot (does not wrap in practice).
 uint32_t uptime_seconds(void);
 
-// Monotonic milliseconds since boot.
+// Monotonic milliseconds since boot (wraps ~49.7 days).
 uint32_t uptime_millis(void);
+
+// Monotonic microseconds since boot (timer resolution, wraps ~71 min).
+// Safe to call from an ISR. Use for short interval deltas only.
+uint32_t uptime_micros(void);
+
+// Raw timer ticks since boot (UPTIME_TICK_US each, wraps ~9.5 h).
+// Safe to call from an ISR. For profiling deltas.
+uint32_t uptime_ticks(void);
+
+// One-shot wake interrupt ticks from now (Timer1 compare B, < 65536).
+// The interrupt only wakes the CPU; disarm after use.
+void uptime_alarm_arm(uint16_t ticks);
+void uptime_alarm_disarm(void);
+
+// Re-time the uptime timer after a system clock change (see clock.h).
+// shift = log2 of the CPU clock divider. Interrupts disabled.
+void uptime_clock_changed(uint8_t shift);
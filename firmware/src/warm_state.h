@@ -0,0 +1,44 @@
+/*
+ * warm_state.h
+ *
+ * Project: Chicken Coop Controller
+ * Purpose: Warm-reset state retention (.noinit RAM)
+ *
+ * Design:
+ *  - One checksummed snapshot of what boot would otherwise rebuild
+ *    the slow or disruptive way: scheduler day context (solar),
+ *    settled device states (door included) and lock state
+ *  - Saved right before sleep, when every device is settled
+ *  - Invalidated the moment any actuator is driven, so a reset
+ *    in the middle of a motion always boots cold
+ *  - Trusted only after a non-power-on reset (caller decides)
+ *
+ * Notes:
+ *  - Storage survives WDT / BOR / external resets, not power loss
+ *  - Checksum guards against SRAM decay during a brown-out
+ *
+ * Updated: 2026-10-18
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "scheduler.h"
+#include "devices/device_ids.h"
+
+struct warm_state {
+    struct scheduler_ctx sched;                     /* day context + solar */
+    uint8_t dev_state[DEVICE_ID_TABLE_SIZE];        /* dev_state_t, settled */
+    uint8_t lock_engaged;                           /* 1 = lock driven home */
+};
+
+/* Store a snapshot (replaces the previous one) */
+void warm_state_save(const struct warm_state *ws);
+
+/* Copy out the snapshot; false if none or checksum mismatch */
+bool warm_state_load(struct warm_state *out);
+
+/* Drop the snapshot (cheap, safe to call often) */
+void warm_state_invalidate(void);
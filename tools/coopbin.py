@@ -0,0 +1,392 @@
+#!/usr/bin/env python3
+#
+# coopbin.py
+#
+# Project: Chicken Coop Controller
+# Purpose: Host side of the binary provisioning protocol
+#          (firmware/src/console/console_bin.h)
+#
+# Usage (CONFIG switch on, console connected):
+#
+#   coopbin.py -p /dev/ttyUSB0 hello
+#   coopbin.py -p /dev/ttyUSB0 config-get coop.json
+#   coopbin.py -p /dev/ttyUSB0 provision coop.json     # config + clock
+#   coopbin.py -p /dev/ttyUSB0 rtc-sync
+#   coopbin.py -p /dev/ttyUSB0 stats
+#   coopbin.py -p /dev/ttyUSB0 log
+#
+# Notes:
+#  - POSIX only (termios), no third-party modules
+#  - Structs use the AVR layout: packed, little-endian
+#  - Config JSON holds every struct config field by name; events
+#    are a list, one entry per used slot
+#
+# Updated: 2026-10-18
+#
+
+import argparse
+import json
+import os
+import select
+import struct
+import sys
+import termios
+import time
+
+BAUD        = termios.B38400
+MAGIC       = b"\x02COOP"
+SOF         = 0xA5
+RESPONSE    = 0x80
+PROTO       = 1
+
+CMD_HELLO        = 0x01
+CMD_CONFIG_READ  = 0x02
+CMD_CONFIG_WRITE = 0x03
+CMD_EVENTS_READ  = 0x04
+CMD_EVENTS_WRITE = 0x05
+CMD_RTC_SET      = 0x06
+CMD_STATS_READ   = 0x07
+CMD_LOG_READ     = 0x08
+CMD_EXIT         = 0x0F
+
+STATUS = ["OK", "CRC", "LEN", "CMD", "INVALID", "RTC"]
+
+# --------------------------------------------------------------------------
+# struct config, CONFIG_VERSION 3 (firmware/src/config.h), AVR layout
+# --------------------------------------------------------------------------
+
+CONFIG_VERSION = 3
+CONFIG_MAGIC   = 0x434F4F50
+MAX_EVENTS     = 8
+
+CONFIG_FIELDS = [
+    # name,              format
+    ("magic",             "I"),
+    ("version",           "B"),
+    (None,                "3x"),
+    ("latitude_e4",       "i"),
+    ("longitude_e4",      "i"),
+    ("tz",                "i"),
+    ("honor_dst",         "B"),
+    ("rtc_set_epoch",     "I"),
+    ("door_travel_ms",    "H"),
+    ("lock_pulse_ms",     "H"),
+    ("door_settle_ms",    "H"),
+    ("lock_settle_ms",    "H"),
+    ("batt_capacity_mah", "H"),
+    ("sleep_ua",          "H"),
+    ("awake_ua",          "H"),
+    ("console_ua",        "H"),
+    ("i2c_nc",            "H"),
+    ("door_motor_ma",     "H"),
+    ("lock_ma",           "H"),
+    ("relay_ma",          "H"),
+    (None,                "2x"),
+]
+
+CONFIG_HEAD = struct.Struct("<" + "".join(f for _, f in CONFIG_FIELDS))
+EVENT       = struct.Struct("<BBBhB")     # device, action, ref, offset, refnum
+CONFIG_SIZE = CONFIG_HEAD.size + EVENT.size * MAX_EVENTS + 2
+
+DEVICES = {"door": 0x01, "led": 0x03, "relay1": 0x04, "relay2": 0x05}
+REFS    = ["none", "midnight", "sunrise", "sunset", "dawn", "dusk"]
+ACTIONS = ["off", "on"]
+LOG_ACT = ["off", "on", "lock", "unlock"]
+LOG_SRC = ["schedule", "button", "console"]
+
+
+def name_of(table, value):
+    for k, v in table.items():
+        if v == value:
+            return k
+    return value
+
+
+def fletcher16(data):
+    s1 = s2 = 0
+    for b in data:
+        s1 = (s1 + b) % 255
+        s2 = (s2 + s1) % 255
+    return (s2 << 8) | s1
+
+
+def crc16(data, crc=0xFFFF):
+    # CRC-16/CCITT-FALSE
+    for b in data:
+        crc ^= b << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def events_decode(raw):
+    out = []
+    for i in range(MAX_EVENTS):
+        dev, act, ref, off, refnum = EVENT.unpack_from(raw, i * EVENT.size)
+        if refnum == 0:
+            continue
+        out.append({"device": name_of(DEVICES, dev),
+                    "action": ACTIONS[act] if act < len(ACTIONS) else act,
+                    "when": REFS[ref] if ref < len(REFS) else ref,
+                    "offset": off})
+    return out
+
+
+def events_encode(events):
+    if len(events) > MAX_EVENTS:
+        sys.exit("too many events (max %d)" % MAX_EVENTS)
+    raw = bytearray(EVENT.size * MAX_EVENTS)
+    for i, e in enumerate(events):
+        dev = e["device"]
+        dev = DEVICES[dev] if isinstance(dev, str) else int(dev)
+        EVENT.pack_into(raw, i * EVENT.size, dev,
+                        ACTIONS.index(e["action"]),
+                        REFS.index(e["when"]),
+                        int(e.get("offset", 0)),
+                        i + 1)              # refnum = slot + 1
+    return bytes(raw)
+
+
+def config_decode(raw):
+    vals = CONFIG_HEAD.unpack_from(raw)
+    names = [n for n, _ in CONFIG_FIELDS if n]
+    cfg = dict(zip(names, vals))
+    cfg["events"] = events_decode(raw[CONFIG_HEAD.size:])
+    del cfg["magic"], cfg["version"]
+    return cfg
+
+
+def config_encode(cfg):
+    vals = []
+    for name, _ in CONFIG_FIELDS:
+        if name == "magic":
+            vals.append(CONFIG_MAGIC)
+        elif name == "version":
+            vals.append(CONFIG_VERSION)
+        elif name:
+            vals.append(int(cfg[name]))
+    body = CONFIG_HEAD.pack(*vals) + events_encode(cfg.get("events", []))
+    return body + struct.pack("<H", fletcher16(body))
+
+
+# --------------------------------------------------------------------------
+# Link
+# --------------------------------------------------------------------------
+
+class ProtoError(Exception):
+    pass
+
+
+class Link:
+
+    def __init__(self, port, timeout=2.0):
+        self.fd = os.open(port, os.O_RDWR | os.O_NOCTTY)
+        self.timeout = timeout
+
+        attr = termios.tcgetattr(self.fd)
+        attr[0] = 0                                     # iflag
+        attr[1] = 0                                     # oflag
+        attr[2] = termios.CS8 | termios.CREAD | termios.CLOCAL
+        attr[3] = 0                                     # lflag
+        attr[4] = attr[5] = BAUD
+        attr[6][termios.VMIN] = 0
+        attr[6][termios.VTIME] = 0
+        termios.tcsetattr(self.fd, termios.TCSANOW, attr)
+
+    def close(self):
+        os.close(self.fd)
+
+    def read(self, n):
+        buf = b""
+        end = time.monotonic() + self.timeout
+        while len(buf) < n:
+            left = end - time.monotonic()
+            if left <= 0:
+                raise ProtoError("timeout")
+            r, _, _ = select.select([self.fd], [], [], left)
+            if r:
+                buf += os.read(self.fd, n - len(buf))
+        return buf
+
+    def drain(self):
+        while select.select([self.fd], [], [], 0.1)[0]:
+            os.read(self.fd, 256)
+
+    def send(self, cmd, payload=b""):
+        body = bytes([cmd]) + struct.pack("<H", len(payload)) + payload
+        frame = bytes([SOF]) + body + struct.pack("<H", crc16(body))
+        os.write(self.fd, frame)
+        termios.tcdrain(self.fd)
+
+    def recv(self, cmd):
+        # Skip anything up to SOF (text left over from the console)
+        while self.read(1)[0] != SOF:
+            pass
+        hdr = self.read(3)
+        n = struct.unpack_from("<H", hdr, 1)[0]
+        payload = self.read(n)
+        crc = struct.unpack("<H", self.read(2))[0]
+        if crc != crc16(hdr + payload):
+            raise ProtoError("response CRC mismatch")
+        if hdr[0] != (cmd | RESPONSE):
+            raise ProtoError("unexpected response 0x%02x" % hdr[0])
+        st = payload[0]
+        if st != 0:
+            raise ProtoError("device status %s" %
+                             (STATUS[st] if st < len(STATUS) else st))
+        return payload[1:]
+
+    def call(self, cmd, payload=b""):
+        self.send(cmd, payload)
+        return self.recv(cmd)
+
+    def enter(self):
+        self.drain()
+        os.write(self.fd, MAGIC)
+        time.sleep(0.05)
+        info = self.call(CMD_HELLO)
+        proto, cfg_ver, cfg_size, max_ev, ev_size = struct.unpack_from(
+            "<BBHBB", info)
+        if (proto != PROTO or cfg_ver != CONFIG_VERSION or
+                cfg_size != CONFIG_SIZE or max_ev != MAX_EVENTS or
+                ev_size != EVENT.size):
+            raise ProtoError("layout mismatch: proto %d config v%d/%d bytes,"
+                             " %d events of %d bytes" %
+                             (proto, cfg_ver, cfg_size, max_ev, ev_size))
+        return info[6:].decode("ascii", "replace")
+
+    def leave(self):
+        self.call(CMD_EXIT)
+
+
+# --------------------------------------------------------------------------
+# Commands
+# --------------------------------------------------------------------------
+
+def rtc_sync(link, latency_ms):
+    now = time.time() + latency_ms / 1000.0
+    sec = int(now)
+    ms = int((now - sec) * 1000)
+    reply = link.call(CMD_RTC_SET,
+                      struct.pack("<IH", sec, ms))
+    epoch, transit = struct.unpack("<IH", reply)
+    print("rtc: set to %s UTC (transit %d ms)" %
+          (time.strftime("%Y-%m-%d %H:%M:%S",
+                         time.gmtime(epoch)), transit))
+
+
+def do_hello(link, args):
+    print("firmware %s, protocol %d, config v%d (%d bytes)" %
+          (args.version, PROTO, CONFIG_VERSION, CONFIG_SIZE))
+
+
+def do_config_get(link, args):
+    cfg = config_decode(link.call(CMD_CONFIG_READ))
+    text = json.dumps(cfg, indent=2) + "\n"
+    if args.file:
+        with open(args.file, "w") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+
+
+def load_json(path):
+    with open(path) as f:
+        return json.load(f)
+
+
+def do_config_set(link, args):
+    link.call(CMD_CONFIG_WRITE, config_encode(load_json(args.file)))
+    print("config: written")
+
+
+def do_events_get(link, args):
+    print(json.dumps(events_decode(link.call(CMD_EVENTS_READ)), indent=2))
+
+
+def do_events_set(link, args):
+    data = load_json(args.file)
+    if isinstance(data, dict):
+        data = data.get("events", [])
+    link.call(CMD_EVENTS_WRITE, events_encode(data))
+    print("events: %d written" % len(data))
+
+
+def do_rtc_sync(link, args):
+    rtc_sync(link, args.latency_ms)
+
+
+def do_provision(link, args):
+    do_config_set(link, args)
+    if not args.no_rtc:
+        rtc_sync(link, args.latency_ms)
+
+
+def do_stats(link, args):
+    raw = link.call(CMD_STATS_READ)
+    count, pos = raw[0], 1
+    for _ in range(count):
+        n = raw[pos]
+        name = raw[pos + 1:pos + 1 + n].decode("ascii")
+        value = struct.unpack_from("<I", raw, pos + 1 + n)[0]
+        pos += 1 + n + 4
+        print("%-18s: %d" % (name, value))
+
+
+def do_log(link, args):
+    raw = link.call(CMD_LOG_READ)
+    count, dropped = struct.unpack_from("<HH", raw)
+    for i in range(count):
+        epoch, dev, act, src = struct.unpack_from("<IBBB", raw, 4 + 7 * i)
+        when = ("(time not set)" if epoch == 0 else
+                time.strftime("%Y-%m-%d %H:%M:%S",
+                              time.gmtime(epoch)) + "Z")
+        print("%-20s  %-7s %-7s %s" % (
+            when, name_of(DEVICES, dev),
+            LOG_ACT[act] if act < len(LOG_ACT) else act,
+            LOG_SRC[src] if src < len(LOG_SRC) else src))
+    print("(%d records, %d dropped)" % (count, dropped))
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Coop binary provisioning")
+    ap.add_argument("-p", "--port", required=True)
+    ap.add_argument("--latency-ms", type=int, default=2,
+                    help="host + adapter send latency added to rtc time")
+    sub = ap.add_subparsers(dest="cmd", required=True)
+
+    sub.add_parser("hello").set_defaults(fn=do_hello)
+    p = sub.add_parser("config-get")
+    p.add_argument("file", nargs="?")
+    p.set_defaults(fn=do_config_get)
+    p = sub.add_parser("config-set")
+    p.add_argument("file")
+    p.set_defaults(fn=do_config_set)
+    sub.add_parser("events-get").set_defaults(fn=do_events_get)
+    p = sub.add_parser("events-set")
+    p.add_argument("file")
+    p.set_defaults(fn=do_events_set)
+    sub.add_parser("rtc-sync").set_defaults(fn=do_rtc_sync)
+    p = sub.add_parser("provision")
+    p.add_argument("file")
+    p.add_argument("--no-rtc", action="store_true")
+    p.set_defaults(fn=do_provision)
+    sub.add_parser("stats").set_defaults(fn=do_stats)
+    sub.add_parser("log").set_defaults(fn=do_log)
+
+    args = ap.parse_args()
+
+    link = Link(args.port)
+    try:
+        args.version = link.enter()
+        args.fn(link, args)
+        link.leave()
+    except ProtoError as e:
+        sys.exit("error: %s" % e)
+    finally:
+        link.close()
+
+
+if __name__ == "__main__":
+    main()